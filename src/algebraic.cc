@@ -533,6 +533,72 @@ bool algebraic::to_decimal(algebraic_g &x, bool weak)
 }
 
 
+bool algebraic::to_double(object_p x, double &result)
+// ----------------------------------------------------------------------------
+//   Convert a real number to a hardware double, return false if we can't
+// ----------------------------------------------------------------------------
+{
+    if (!x)
+        return false;
+    id xt = x->type();
+    switch(xt)
+    {
+    case ID_integer:
+        result = integer_p(x)->value<ularge>();
+        return true;
+    case ID_neg_integer:
+        result = -double(integer_p(x)->value<ularge>());
+        return true;
+    case ID_fraction:
+    case ID_neg_fraction:
+    {
+        fraction_p f = fraction_p(x);
+        result = double(f->numerator_value()) / f->denominator_value();
+        if (xt == ID_neg_fraction)
+            result = -result;
+        return true;
+    }
+    case ID_bignum:
+    case ID_neg_bignum:
+    {
+        size_t size = 0;
+        byte_p data = bignum_p(x)->value(&size);
+        result = 0.0;
+        while (size--)
+            result = result * 256.0 + data[size];
+        if (xt == ID_neg_bignum)
+            result = -result;
+        return std::isfinite(result);
+    }
+    case ID_big_fraction:
+    case ID_neg_big_fraction:
+    {
+        big_fraction_p f = big_fraction_p(x);
+        double         d = 0.0;
+        if (!to_double(+f->numerator(), result) ||
+            !to_double(+f->denominator(), d))
+            return false;
+        result /= d;
+        if (xt == ID_neg_big_fraction)
+            result = -result;
+        return std::isfinite(result);
+    }
+    case ID_hwfloat:
+        result = hwfloat_p(x)->value();
+        return true;
+    case ID_hwdouble:
+        result = hwdouble_p(x)->value();
+        return true;
+    case ID_decimal:
+    case ID_neg_decimal:
+        result = decimal_p(x)->to_double();
+        return std::isfinite(result);
+    default:
+        return false;
+    }
+}
+
+
 algebraic_g algebraic::pi()
 // ----------------------------------------------------------------------------
 //   Return the value of pi
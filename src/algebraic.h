@@ -71,6 +71,9 @@ struct algebraic : command
     // Convert to decimal number
     static bool to_decimal(algebraic_g &x, bool weak = false);
 
+    // Convert a real number to a hardware double
+    static bool to_double(object_p x, double &result);
+
     // Convert to decimal if this is a big value
     static bool to_decimal_if_big(algebraic_g &x)
     {
@@ -1403,6 +1403,7 @@ template object::result arithmetic::evaluate<struct atan2>();
 
 template algebraic_p arithmetic::evaluate<struct mod>(algebraic_r x, algebraic_r y);
 template algebraic_p arithmetic::evaluate<struct rem>(algebraic_r x, algebraic_r y);
+template algebraic_p arithmetic::evaluate<struct pow>(algebraic_r x, algebraic_r y);
 template algebraic_p arithmetic::evaluate<struct hypot>(algebraic_r x, algebraic_r y);
 template algebraic_p arithmetic::evaluate<struct atan2>(algebraic_r x, algebraic_r y);
 
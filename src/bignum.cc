@@ -32,11 +32,13 @@
 #include "fraction.h"
 #include "integer.h"
 #include "parser.h"
+#include "program.h"
 #include "renderer.h"
 #include "runtime.h"
 #include "settings.h"
 #include "utf8.h"
 
+#include <algorithm>
 #include <stdio.h>
 
 
@@ -170,43 +172,24 @@ static size_t render_num(renderer &r,
     else
         r.flush();
 
-    // Get denominator for the base
-    size_t findex = r.size();
-    bignum_g b = rt.make<bignum>(object::ID_bignum, base);
+    // Compute all the digits at once, then emit them with separators
     bignum_g n = (bignum *) num;
-
-    // Keep dividing by the base until we get 0
-    uint sep = 0;
-    do
+    text_g digits = bignum::to_digits(n, base);
+    if (!digits)
+        return r.size();
+    size_t count = 0;
+    gcutf8 d = digits->value(&count);
+    for (size_t i = 0; i < count; i++)
     {
-        bignum_g remainder = nullptr;
-        bignum_g quotient = nullptr;
-        if (!bignum::quorem(n, b, bignum::ID_bignum, &quotient, &remainder))
-            break;
-        uint digit = remainder->value<uint>();
-        if (digit > base)
-        {
-            printf("Ooops: digit=%u, base=%u\n", digit, base);
-            bignum::quorem(n, b, bignum::ID_bignum, &quotient, &remainder);
-        }
+        if (i && spacing && (count - i) % spacing == 0)
+            r.put(space);
+        uint digit = (+d)[i];
         unicode c = upper        ? fancy_upper_digits[digit]
                   : lower        ? fancy_lower_digits[digit]
                   : (digit < 10) ? digit + '0'
                                  : digit + ('A' - 10);
         r.put(c);
-        n = quotient;
-
-        if (!n->is_zero() && ++sep == spacing)
-        {
-            sep = 0;
-            r.put(space);
-        }
-    } while (!n->is_zero());
-
-    // Revert the digits
-    byte *dest  = (byte *) r.text();
-    bool multibyte = upper || lower || (spacing && space > 0xFF);
-    utf8_reverse(dest + findex, dest + r.size(), multibyte);
+    }
 
     // Add suffix if there is one
     if (fancy_base)
@@ -488,10 +471,169 @@ bignum_g operator^(bignum_r y, bignum_r x)
 }
 
 
+// Limbs used for multiplication, and threshold for Karatsuba multiplication
+typedef uint32_t limb;
+typedef uint64_t dlimb;
+static const size_t KARATSUBA_THRESHOLD = 24;
+
+
+static void limb_mul(limb *r, const limb *a, size_t na, const limb *b, size_t nb)
+// ----------------------------------------------------------------------------
+//   Schoolbook multiplication of limbs, r has na + nb limbs
+// ----------------------------------------------------------------------------
+{
+    for (size_t i = 0; i < na + nb; i++)
+        r[i] = 0;
+    for (size_t i = 0; i < na; i++)
+    {
+        dlimb c  = 0;
+        dlimb ai = a[i];
+        if (!ai)
+            continue;
+        for (size_t j = 0; j < nb; j++)
+        {
+            c += ai * b[j] + r[i + j];
+            r[i + j] = limb(c);
+            c >>= 32;
+        }
+        r[i + nb] = limb(c);
+    }
+}
+
+
+static limb limb_add(limb *r, const limb *a, size_t n)
+// ----------------------------------------------------------------------------
+//   Add n limbs of a to r in place, return the carry
+// ----------------------------------------------------------------------------
+{
+    dlimb c = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        c += dlimb(r[i]) + a[i];
+        r[i] = limb(c);
+        c >>= 32;
+    }
+    return limb(c);
+}
+
+
+static void limb_sub(limb *r, const limb *a, size_t n)
+// ----------------------------------------------------------------------------
+//   Subtract n limbs of a from r in place, r must be larger than a
+// ----------------------------------------------------------------------------
+{
+    limb borrow = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        dlimb d = dlimb(r[i]) - a[i] - borrow;
+        r[i] = limb(d);
+        borrow = (d >> 32) & 1;
+    }
+    for (size_t i = n; borrow; i++)
+        borrow = r[i]-- == 0;
+}
+
+
+static limb *limb_align(byte *p)
+// ----------------------------------------------------------------------------
+//   Return the first limb-aligned address at or after p
+// ----------------------------------------------------------------------------
+{
+    return (limb *) ((uintptr_t(p) + sizeof(limb) - 1)
+                     & ~uintptr_t(sizeof(limb) - 1));
+}
+
+
+static void limb_unpack(limb *r, size_t n, byte_p p, size_t bytes)
+// ----------------------------------------------------------------------------
+//   Convert little-endian bytes into n limbs, padding with zeroes
+// ----------------------------------------------------------------------------
+{
+    for (size_t i = 0; i < n; i++)
+        r[i] = 0;
+    for (size_t i = 0; i < bytes; i++)
+        r[i / 4] |= limb(p[i]) << (8 * (i % 4));
+}
+
+
+static size_t limb_pack(byte *p, size_t bytes, const limb *a, size_t n)
+// ----------------------------------------------------------------------------
+//   Convert n limbs back into bytes, return size without leading zeroes
+// ----------------------------------------------------------------------------
+{
+    for (size_t i = 0; i < bytes; i++)
+        p[i] = i / 4 < n ? byte(a[i / 4] >> (8 * (i % 4))) : 0;
+    while (bytes > 0 && p[bytes - 1] == 0)
+        bytes--;
+    return bytes;
+}
+
+
+static size_t karatsuba_space(size_t n)
+// ----------------------------------------------------------------------------
+//   Workspace required by karatsuba() for n-limb operands
+// ----------------------------------------------------------------------------
+{
+    if (n < KARATSUBA_THRESHOLD)
+        return 0;
+    size_t l = n - n / 2 + 1;
+    return 4 * l + karatsuba_space(l);
+}
+
+
+static void karatsuba(limb *r, const limb *a, const limb *b, size_t n,
+                      limb *ws)
+// ----------------------------------------------------------------------------
+//   Compute the 2n limbs of the product of two n-limb operands
+// ----------------------------------------------------------------------------
+//   With a = a0 + B^h a1 and b = b0 + B^h b1, we compute z0 = a0*b0,
+//   z2 = a1*b1 and z1 = (a0+a1)*(b0+b1) - z0 - z2, which is never negative,
+//   and then a*b = z0 + B^h z1 + B^2h z2
+{
+    if (n < KARATSUBA_THRESHOLD)
+    {
+        limb_mul(r, a, n, b, n);
+        return;
+    }
+
+    size_t h  = n / 2;
+    size_t l  = n - h + 1;
+    limb  *sa = ws;
+    limb  *sb = sa + l;
+    limb  *z1 = sb + l;
+    karatsuba(r, a, b, h, ws);
+    karatsuba(r + 2 * h, a + h, b + h, n - h, ws);
+    for (size_t i = 0; i < l; i++)
+        sa[i] = sb[i] = 0;
+    for (size_t i = 0; i < n - h; i++)
+    {
+        sa[i] = a[h + i];
+        sb[i] = b[h + i];
+    }
+    limb ca = limb_add(sa, a, h);
+    limb cb = limb_add(sb, b, h);
+    for (size_t i = h; ca && i < l; i++)
+        ca = ++sa[i] == 0;
+    for (size_t i = h; cb && i < l; i++)
+        cb = ++sb[i] == 0;
+    karatsuba(z1, sa, sb, l, z1 + 2 * l);
+    limb_sub(z1, r, 2 * h);
+    limb_sub(z1, r + 2 * h, 2 * (n - h));
+
+    // Add the middle product, 2l <= 2n - h since h >= 2
+    limb c = limb_add(r + h, z1, 2 * l);
+    for (size_t i = h + 2 * l; c && i < 2 * n; i++)
+        c = ++r[i] == 0;
+}
+
+
 bignum_g bignum::multiply(bignum_r yg, bignum_r xg, id ty)
 // ----------------------------------------------------------------------------
 //   Perform multiply operation on the two big nums, with result type ty
 // ----------------------------------------------------------------------------
+//   The bytes are converted to 32-bit limbs, multiplied using 64-bit
+//   products, with Karatsuba for large operands, and converted back.
+//   For based numbers, only the low bytes of the inputs are used.
 {
     size_t xs = 0;
     size_t ys = 0;
@@ -508,50 +650,69 @@ bignum_g bignum::multiply(bignum_r yg, bignum_r xg, id ty)
     }
     if (wbits && needed > wbytes)
         needed = wbytes;
-    byte *buffer = rt.allocate(needed);       // May GC here
+    xs = std::min(xs, needed);
+    ys = std::min(ys, needed);
+
+    // Make x the longest operand
+    bool swap = xs < ys;
+    if (swap)
+        std::swap(xs, ys);
+    size_t nx = (xs + 3) / 4;
+    size_t ny = (ys + 3) / 4;
+    size_t nr = nx + ny;
+    size_t nw = 0;
+    if (ny >= KARATSUBA_THRESHOLD)
+        nw = 2 * ny + karatsuba_space(ny);
+
+    // Allocate result bytes followed by aligned limbs
+    size_t scratch = needed + sizeof(limb) + (nx+ny+nr+nw) * sizeof(limb);
+    byte *buffer = rt.allocate(scratch);      // May GC here
     if (!buffer)
         return nullptr;                       // Out of memory
     x = xg->value(&xs);                       // Re-read after potential GC
     y = yg->value(&ys);
+    xs = std::min(xs, needed);
+    ys = std::min(ys, needed);
+    if (swap)
+    {
+        std::swap(x, y);
+        std::swap(xs, ys);
+    }
 
-    // Zero-initialie the result
-    for (size_t i = 0; i < needed; i++)
-        buffer[i] = 0;
+    limb *xl = limb_align(buffer + needed);
+    limb *yl = xl + nx;
+    limb *rl = yl + ny;
+    limb *ws = rl + nr;
+    limb_unpack(xl, nx, x, xs);
+    limb_unpack(yl, ny, y, ys);
 
-    // Loop on all bytes of x then y
-    for (size_t xi = 0; xi < xs; xi++)
+    if (nw)
     {
-        byte xd = x[xi];
-        for (int bit = 0; xd && bit < 8; bit++)
+        // Multiply slices of x of the size of y with Karatsuba
+        for (size_t i = 0; i < nr; i++)
+            rl[i] = 0;
+        for (size_t i = 0; i < nx; i += ny)
         {
-            if (xd & (1<<bit))
-            {
-                uint c = 0;
-                size_t yi;
-                for (yi = 0; yi < ys && xi + yi < needed; yi++)
-                {
-                    c += buffer[xi + yi] + (y[yi] << bit);
-                    buffer[xi + yi] = byte(c);
-                    c >>= 8;
-                }
-                while (c && xi + yi < needed)
-                {
-                    c += buffer[xi + yi];
-                    buffer[xi + yi] = byte(c);
-                    c >>= 8;
-                    yi++;
-                }
-                xd &= ~(1<<bit);
-            }
+            size_t n = std::min(ny, nx - i);
+            if (n == ny)
+                karatsuba(ws, xl + i, yl, ny, ws + 2 * ny);
+            else
+                limb_mul(ws, yl, ny, xl + i, n);
+            limb c = limb_add(rl + i, ws, n + ny);
+            for (size_t j = i + n + ny; c && j < nr; j++)
+                c = ++rl[j] == 0;
         }
     }
+    else
+    {
+        limb_mul(rl, xl, nx, yl, ny);
+    }
 
-    size_t sz = needed;
-    while (sz > 0 && buffer[sz-1] == 0)
-        sz--;
+    // Convert back to bytes
+    size_t sz = limb_pack(buffer, needed, rl, nr);
     gcbytes buf = buffer;
     bignum_g result = rt.make<bignum>(ty, buf, sz);
-    rt.free(needed);
+    rt.free(scratch);
     return result;
 }
 
@@ -570,6 +731,102 @@ bignum_g operator*(bignum_r y, bignum_r x)
 }
 
 
+static void limb_divmod(limb *q, limb *u, size_t nu,
+                        const limb *v, size_t nv, limb *vn)
+// ----------------------------------------------------------------------------
+//   Divide nu limbs of u by nv limbs of v, with nu >= nv
+// ----------------------------------------------------------------------------
+//   This uses Knuth's algorithm D. u must have room for nu + 1 limbs, and
+//   is replaced with the remainder. q receives nu - nv + 1 limbs. vn is nv
+//   limbs of workspace for the normalized divisor, and can be v itself.
+//   The top limb of v must not be zero.
+{
+    if (nv == 1)
+    {
+        // Short division by a single limb
+        dlimb d = v[0];
+        dlimb rem = 0;
+        for (size_t i = nu; i-- > 0; )
+        {
+            rem = (rem << 32) | u[i];
+            q[i] = limb(rem / d);
+            rem %= d;
+        }
+        u[0] = limb(rem);
+        for (size_t i = 1; i <= nu; i++)
+            u[i] = 0;
+        return;
+    }
+
+    // Normalize so that the top bit of vn is set
+    uint shift = __builtin_clz(v[nv - 1]);
+    u[nu] = 0;
+    if (shift)
+    {
+        for (size_t i = nv - 1; i > 0; i--)
+            vn[i] = (v[i] << shift) | (v[i - 1] >> (32 - shift));
+        vn[0] = v[0] << shift;
+        for (size_t i = nu; i > 0; i--)
+            u[i] = (u[i] << shift) | (u[i - 1] >> (32 - shift));
+        u[0] <<= shift;
+    }
+    else if (vn != v)
+    {
+        for (size_t i = 0; i < nv; i++)
+            vn[i] = v[i];
+    }
+
+    dlimb vtop = vn[nv - 1];
+    dlimb vnext = vn[nv - 2];
+    for (size_t j = nu - nv + 1; j-- > 0; )
+    {
+        // Estimate quotient limb from the top two limbs, off by 2 at most
+        dlimb top = (dlimb(u[j + nv]) << 32) | u[j + nv - 1];
+        dlimb qhat = top / vtop;
+        dlimb rhat = top % vtop;
+        while ((qhat >> 32) ||
+               qhat * vnext > ((rhat << 32) | u[j + nv - 2]))
+        {
+            qhat--;
+            rhat += vtop;
+            if (rhat >> 32)
+                break;
+        }
+
+        // Multiply and subtract
+        int64_t t = 0;
+        int64_t k = 0;
+        for (size_t i = 0; i < nv; i++)
+        {
+            dlimb p = qhat * vn[i];
+            t = int64_t(u[i + j]) - k - int64_t(p & 0xFFFFFFFFu);
+            u[i + j] = limb(t);
+            k = int64_t(p >> 32) - (t >> 32);
+        }
+        t = int64_t(u[j + nv]) - k;
+        u[j + nv] = limb(t);
+
+        // If we subtracted too much, add back
+        if (t < 0)
+        {
+            qhat--;
+            u[j + nv] += limb_add(u + j, vn, nv);
+        }
+        q[j] = limb(qhat);
+    }
+
+    // Unnormalize the remainder
+    if (shift)
+    {
+        for (size_t i = 0; i + 1 < nv; i++)
+            u[i] = (u[i] >> shift) | (u[i + 1] << (32 - shift));
+        u[nv - 1] >>= shift;
+    }
+    for (size_t i = nv; i <= nu; i++)
+        u[i] = 0;
+}
+
+
 bool bignum::quorem(bignum_r yg, bignum_r xg, id ty, bignum_g *q, bignum_g *r)
 // ----------------------------------------------------------------------------
 //   Compute quotient and remainder of two bignums, as bignums
@@ -590,7 +847,8 @@ bool bignum::quorem(bignum_r yg, bignum_r xg, id ty, bignum_g *q, bignum_g *r)
     // For example in 0x17B/0xEF, the first remainder subtraction will be
     // 0x17B - 0xEF, which does require two bytes, not just one. It could
     // be carried out by keeping the extra byte in a variable, but it's
-    // simpler to allocate one extra byte.
+    // simpler to allocate one extra byte. Similarly, the normalized
+    // numerator used for long division below gets one extra limb.
     size_t xs = 0;
     size_t ys = 0;
     byte_p x = xg->value(&xs);                // Read those after potential GC
@@ -599,67 +857,31 @@ bool bignum::quorem(bignum_r yg, bignum_r xg, id ty, bignum_g *q, bignum_g *r)
     size_t wbits = wordsize(xt);
     size_t wbytes = (wbits + 7) / 8;
     size_t needed = ys + xs + 1;              // No need to check maxbignum
-    byte *buffer = rt.allocate(needed);       // May GC here
+    size_t nx = (xs + 3) / 4;
+    size_t ny = (ys + 3) / 4;
+    size_t scratch = needed + sizeof(limb) + (2 * ny + nx + 2) * sizeof(limb);
+    byte *buffer = rt.allocate(scratch);      // May GC here
     if (!buffer)
         return false;                         // Out of memory
     x = xg->value(&xs);                       // Re-read after potential GC
     y = yg->value(&ys);
 
-    // Pointers ot quotient and remainder, initializer to 0
+    // Pointers ot quotient and remainder, and limbs used for the division
     byte *quotient = buffer;
     byte *remainder = quotient + ys;
-    size_t rs = 0;
-    size_t qs = 0;
-    for (uint i = 0; i < needed; i++)
-        buffer[i] = 0;
+    limb *un = limb_align(buffer + needed);   // Numerator, then remainder
+    limb *vn = un + ny + 1;                   // Denominator
+    limb *ql = vn + nx;                       // Quotient
+    limb_unpack(un, ny + 1, y, ys);
+    limb_unpack(vn, nx, x, xs);
+    for (size_t i = 0; i <= ny; i++)
+        ql[i] = 0;
 
-    // Loop on the numerator
-    for (int yi = ys-1; yi >= 0; yi--)
-    {
-        for (int bit = 7; bit >= 0; bit--)
-        {
-            // Shift remainder left by one bit, add numerator bit
-            uint16_t c = (y[yi] >> bit) & 1;
-            int delta = 0;
-            for (uint ri = 0; ri < rs; ri++)
-            {
-                c += (remainder[ri] << 1);
-                remainder[ri] = byte(c);
-                if (int d = remainder[ri] - x[ri])
-                    delta = d;
-                c >>= 8;
-            }
+    if (ny >= nx)
+        limb_divmod(ql, un, ny, vn, nx, vn);
 
-            if (c)
-            {
-                if (int d = c - x[rs])
-                    delta = d;
-                remainder[rs++] = c;
-            }
-            if (rs != xs)
-                delta = int(rs) - int(xs);
-
-            // If remainder >= denominator, add to quotient, subtract from rem
-            if (delta >= 0)
-            {
-                quotient[yi] |= (1 << bit);
-                if (qs < size_t(yi + 1))
-                    qs = yi + 1;
-
-                c = 0;
-                for (uint ri = 0; ri < rs; ri++)
-                {
-                    c = remainder[ri] - (ri < xs ? x[ri] : 0) - c;
-                    remainder[ri] = byte(c);
-                    c = c > 0xFF;
-                }
-
-                // Strip zeroes at top of remainder
-                while (rs > 0 && remainder[rs-1] == 0)
-                    rs--;
-            }
-        } // numerator bit loop
-    } // numerator byte loop
+    size_t qs = limb_pack(quotient, ys, ql, ny + 1);
+    size_t rs = limb_pack(remainder, xs + 1, un, ny + 1);
 
     // Generate results
     gcutf8 qg = quotient;
@@ -679,11 +901,507 @@ bool bignum::quorem(bignum_r yg, bignum_r xg, id ty, bignum_g *q, bignum_g *r)
         *r = rt.make<bignum>(ty, rg, rs);
         ok = bignum_p(*r) != nullptr;
     }
-    rt.free(needed);
+    rt.free(scratch);
     return ok;
 }
 
 
+static uint radix_chunk(uint base, limb *bk)
+// ----------------------------------------------------------------------------
+//   Return the number of digits in the base that fit in a limb, and its power
+// ----------------------------------------------------------------------------
+{
+    dlimb power = base;
+    uint  count = 1;
+    while (power * base <= 0xFFFFFFFFu)
+    {
+        power *= base;
+        count++;
+    }
+    *bk = limb(power);
+    return count;
+}
+
+
+static size_t limb_size(const limb *a, size_t n)
+// ----------------------------------------------------------------------------
+//   Return the number of limbs once leading zeroes are stripped
+// ----------------------------------------------------------------------------
+{
+    while (n > 0 && a[n - 1] == 0)
+        n--;
+    return n;
+}
+
+
+static int limb_compare(const limb *a, size_t na, const limb *b, size_t nb)
+// ----------------------------------------------------------------------------
+//   Compare two limb values
+// ----------------------------------------------------------------------------
+{
+    na = limb_size(a, na);
+    nb = limb_size(b, nb);
+    if (na != nb)
+        return na < nb ? -1 : 1;
+    for (size_t i = na; i-- > 0; )
+        if (a[i] != b[i])
+            return a[i] < b[i] ? -1 : 1;
+    return 0;
+}
+
+
+static inline uint digit_value(byte c)
+// ----------------------------------------------------------------------------
+//   Value of a digit that was already validated by the parser
+// ----------------------------------------------------------------------------
+{
+    return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+}
+
+
+bignum_g bignum::from_digits(id ty, uint base, ularge high,
+                             gcutf8 digits, size_t count)
+// ----------------------------------------------------------------------------
+//   Build a bignum from the value of high followed by count digits
+// ----------------------------------------------------------------------------
+//   Digits are grouped in limb-sized chunks, then adjacent blocks are merged
+//   pairwise, multiplying the high block by a power of the base that is
+//   squared at each level. With Karatsuba, this is subquadratic.
+{
+    // Digits of the high part, most significant first
+    byte   hd[64];
+    size_t hn = 0;
+    for (ularge h = high; h; h /= base)
+        hd[hn++] = h % base;
+    std::reverse(hd, hd + hn);
+
+    limb   bk    = 0;
+    uint   k     = radix_chunk(base, &bk);
+    size_t total = hn + count;
+    size_t m     = (total + k - 1) / k;
+    size_t w     = 1;
+    while (w < m)
+        w *= 2;
+    size_t nw      = karatsuba_space(w / 2);
+    size_t scratch = 4 * w + sizeof(limb) + (4 * w + nw) * sizeof(limb);
+    byte  *buffer  = rt.allocate(scratch);    // May GC here
+    if (!buffer)
+        return nullptr;
+    limb *data = limb_align(buffer + 4 * w);
+    limb *tmp  = data + w;
+    limb *pw   = tmp + w;
+    limb *ws   = pw + w;
+
+    // Fill chunks, least significant first
+    utf8 txt = digits;
+    for (size_t c = 0; c < w; c++)
+    {
+        limb   value = 0;
+        size_t last  = c * k < total ? total - c * k : 0;
+        size_t first = last > k ? last - k : 0;
+        for (size_t d = first; d < last; d++)
+            value = value * base + (d < hn ? hd[d] : digit_value(txt[d - hn]));
+        data[c] = value;
+    }
+
+    // Merge blocks of n chunks, pw being the power of the base for n chunks
+    pw[0] = bk;
+    for (size_t n = 1; n < w; n *= 2)
+    {
+        for (size_t b = 0; b < w; b += 2 * n)
+        {
+            limb *lo = data + b;
+            limb *hi = lo + n;
+            if (!limb_size(hi, n))
+                continue;
+            karatsuba(tmp, hi, pw, n, ws);
+            limb c = limb_add(tmp, lo, n);
+            for (size_t i = n; c && i < 2 * n; i++)
+                c = ++tmp[i] == 0;
+            for (size_t i = 0; i < 2 * n; i++)
+                lo[i] = tmp[i];
+        }
+        if (2 * n < w)
+        {
+            karatsuba(tmp, pw, pw, n, ws);
+            for (size_t i = 0; i < 2 * n; i++)
+                pw[i] = tmp[i];
+        }
+    }
+
+    size_t sz = limb_pack(buffer, 4 * w, data, w);
+    if (sz * 8 > Settings.MaxNumberBits())
+    {
+        rt.free(scratch);
+        rt.number_too_big_error();
+        return nullptr;
+    }
+    size_t wbits  = wordsize(ty);
+    size_t wbytes = (wbits + 7) / 8;
+    if (wbits && sz >= wbytes)
+    {
+        // Truncate to the word size, including for sizes like 12 bits
+        sz = wbytes;
+        if (wbits % 8)
+            buffer[sz - 1] &= byte(0xFFu >> (8 - wbits % 8));
+        while (sz > 0 && buffer[sz - 1] == 0)
+            sz--;
+    }
+    gcbytes buf = buffer;
+    bignum_g result = rt.make<bignum>(ty, buf, sz);
+    rt.free(scratch);
+    return result;
+}
+
+
+static byte *radix_digits(byte   *out,
+                          limb   *v,
+                          size_t  n,
+                          size_t  level,
+                          limb  **powers,
+                          size_t *psize,
+                          uint    base,
+                          uint    k,
+                          limb    bk,
+                          limb   *ws)
+// ----------------------------------------------------------------------------
+//   Write exactly 2^(level+1) chunks of k digits for v < powers[level]^2
+// ----------------------------------------------------------------------------
+//   v has room for n + 1 limbs and is destroyed in the process.
+//   The quotient and remainder by powers[level] give the high and low halves.
+{
+    size_t chunks = size_t(2) << level;
+    n = limb_size(v, n);
+    if (psize[level] < 8)
+    {
+        // Short division for the smallest values
+        for (size_t c = chunks; c-- > 0; )
+        {
+            dlimb rem = 0;
+            for (size_t i = n; i-- > 0; )
+            {
+                rem = (rem << 32) | v[i];
+                v[i] = limb(rem / bk);
+                rem %= bk;
+            }
+            n = limb_size(v, n);
+            byte *chunk = out + c * k;
+            for (uint d = k; d-- > 0; rem /= base)
+                chunk[d] = rem % base;
+        }
+        return out + chunks * k;
+    }
+
+    size_t half = chunks / 2 * k;
+    size_t s    = psize[level];
+    if (n < s)
+    {
+        for (size_t i = 0; i < half; i++)
+            out[i] = 0;
+        return radix_digits(out + half, v, n, level - 1,
+                            powers, psize, base, k, bk, ws);
+    }
+
+    limb  *q  = ws;
+    size_t nq = n - s + 1;
+    limb  *vn = q + nq + 1;
+    for (size_t i = 0; i <= nq; i++)
+        q[i] = 0;
+    limb_divmod(q, v, n, powers[level], s, vn);
+    ws = vn + s;
+    out = radix_digits(out, q, nq, level - 1,
+                       powers, psize, base, k, bk, ws);
+    return radix_digits(out, v, s, level - 1,
+                        powers, psize, base, k, bk, ws);
+}
+
+
+text_g bignum::to_digits(bignum_r x, uint base)
+// ----------------------------------------------------------------------------
+//   Return a text containing the digit values of x, most significant first
+// ----------------------------------------------------------------------------
+//   For powers of two, the digits are simply extracted from the bits.
+//   Otherwise, the value is recursively split by cached powers of the base.
+{
+    size_t xs = 0;
+    byte_p xv = x->value(&xs);
+    while (xs > 0 && xv[xs - 1] == 0)
+        xs--;
+    if (!xs)
+    {
+        static const byte zero[1] = { 0 };
+        gcutf8 digits = zero;
+        return rt.make<text>(ID_text, digits, 1);
+    }
+
+    if ((base & (base - 1)) == 0)
+    {
+        uint   bits  = __builtin_ctz(base);
+        size_t count = (xs * 8 + bits - 1) / bits;
+        byte  *out   = rt.allocate(count);    // May GC here
+        if (!out)
+            return nullptr;
+        xv = x->value(&xs);
+        for (size_t d = 0; d < count; d++)
+        {
+            uint value = 0;
+            for (uint b = 0; b < bits; b++)
+            {
+                size_t bit = d * bits + b;
+                if (bit / 8 < xs && (xv[bit / 8] >> (bit % 8)) & 1)
+                    value |= 1 << b;
+            }
+            out[count - 1 - d] = value;
+        }
+        size_t lead = 0;
+        while (lead + 1 < count && out[lead] == 0)
+            lead++;
+        gcutf8 digits = out + lead;
+        text_g result = rt.make<text>(ID_text, digits, count - lead);
+        rt.free(count);
+        return result;
+    }
+
+    limb   bk     = 0;
+    uint   k      = radix_chunk(base, &bk);
+    size_t n      = (xs + 3) / 4;
+    uint   bpc    = 31 - __builtin_clz(bk);
+    size_t chunks = 1;
+    while (chunks * bpc <= 32 * (n + 1))
+        chunks *= 2;
+    size_t levels = __builtin_ctzl(chunks);  // bk^chunks > x at last level
+    size_t nw     = std::max(3 * n + 2 * levels + 16, karatsuba_space(chunks));
+    size_t scratch = chunks * k + sizeof(limb)
+        + (n + 1 + chunks + nw) * sizeof(limb);
+    byte *buffer = rt.allocate(scratch);      // May GC here
+    if (!buffer)
+        return nullptr;
+    xv = x->value(&xs);
+
+    byte  *out = buffer;
+    limb  *v   = limb_align(out + chunks * k);
+    limb  *pw  = v + n + 1;
+    limb  *ws  = pw + chunks;
+    limb  *powers[64];
+    size_t psize[64];
+    limb_unpack(v, n + 1, xv, xs);
+
+    // Cache powers bk^(2^j) until the square of the last one exceeds x
+    size_t level = 0;
+    powers[0] = pw;
+    psize[0] = 1;
+    pw[0] = bk;
+    for (;;)
+    {
+        size_t s = psize[level];
+        if (2 * s - 1 > n || level + 1 >= levels)
+            break;
+        limb *next = powers[level] + (size_t(1) << level);
+        karatsuba(next, powers[level], powers[level], size_t(1) << level, ws);
+        size_t ns = limb_size(next, size_t(2) << level);
+        if (limb_compare(next, ns, v, n) > 0)
+            break;
+        powers[++level] = next;
+        psize[level] = ns;
+    }
+
+    byte *end = radix_digits(out, v, n, level, powers, psize, base, k, bk, ws);
+    size_t count = end - out;
+    size_t lead = 0;
+    while (lead + 1 < count && out[lead] == 0)
+        lead++;
+    gcutf8 digits = out + lead;
+    text_g result = rt.make<text>(ID_text, digits, count - lead);
+    rt.free(scratch);
+    return result;
+}
+
+
+ularge bignum::gcd(ularge a, ularge b)
+// ----------------------------------------------------------------------------
+//   Binary GCD of two native integers
+// ----------------------------------------------------------------------------
+{
+    if (!a)
+        return b;
+    if (!b)
+        return a;
+    uint shift = __builtin_ctzll(a | b);
+    a >>= __builtin_ctzll(a);
+    do
+    {
+        b >>= __builtin_ctzll(b);
+        if (a > b)
+            std::swap(a, b);
+        b -= a;
+    } while (b);
+    return a << shift;
+}
+
+
+static large lehmer_top(const limb *x, size_t n, size_t bit)
+// ----------------------------------------------------------------------------
+//   Extract the 62 bits of x starting at the given bit
+// ----------------------------------------------------------------------------
+{
+    ularge result = 0;
+    for (uint i = 0; i < 62; i += 31)
+    {
+        size_t b = bit + i;
+        size_t l = b / 32;
+        dlimb  v = l < n ? x[l] : 0;
+        if (l + 1 < n)
+            v |= dlimb(x[l + 1]) << 32;
+        result |= ((v >> (b % 32)) & 0x7FFFFFFF) << i;
+    }
+    return large(result);
+}
+
+
+static void lehmer_combine(limb *r, const limb *a, const limb *b, size_t n,
+                           large ca, large cb)
+// ----------------------------------------------------------------------------
+//   Compute r = ca * a + cb * b, where the result is known to be positive
+// ----------------------------------------------------------------------------
+//   The cofactors are less than 2^31 in magnitude, so that products fit.
+{
+    large carry = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        large t = ca * large(a[i]) + cb * large(b[i]) + carry;
+        r[i] = limb(t);
+        carry = t >> 32;
+    }
+    r[n] = limb(carry);
+}
+
+
+static limb *limb_gcd(limb *a, limb *b, size_t n, limb *work, size_t *size)
+// ----------------------------------------------------------------------------
+//   Compute the GCD of a and b with Lehmer's algorithm
+// ----------------------------------------------------------------------------
+//   Each step runs Euclid's algorithm on the leading 62 bits of both values,
+//   accumulating cofactors as long as the quotients are certain, then
+//   applies them to the full values. This replaces about 30 bits worth of
+//   long divisions with a single linear pass. When no quotient is certain,
+//   a long division is performed instead. Values that fit in 64 bits are
+//   finished with a native binary GCD.
+//   The values a and b have n limbs plus one free limb, and are destroyed.
+//   The work area must have room for 4 * n + 2 limbs. The result is
+//   stored in one of these arrays, and its size is returned in size.
+{
+    limb *ta = work;
+    limb *tb = ta + n + 1;
+    limb *q  = tb + n + 1;
+    limb *mn = q + n;
+    a[n] = b[n] = 0;
+    if (limb_compare(a, n, b, n) < 0)
+        std::swap(a, b);
+
+    size_t na = limb_size(a, n);
+    size_t nb = limb_size(b, n);
+    while (nb > 2)
+    {
+        // Leading bits of a and b, at the same position
+        size_t bits = 32 * na - __builtin_clz(a[na - 1]);
+        size_t pos  = bits - 62;
+        large  ah   = lehmer_top(a, na, pos);
+        large  bh   = lehmer_top(b, nb, pos);
+
+        // Euclid on the leading bits, with A, B, C, D the cofactors
+        large A = 1, B = 0, C = 0, D = 1;
+        const large MAX = large(1) << 31;
+        while (bh + C > 0 && bh + D > 0)
+        {
+            large qt = (ah + A) / (bh + C);
+            if (qt != (ah + B) / (bh + D))
+                break;
+            large nc = A - qt * C;
+            large nd = B - qt * D;
+            if (nc <= -MAX || nc >= MAX || nd <= -MAX || nd >= MAX)
+                break;
+            A = C;
+            C = nc;
+            B = D;
+            D = nd;
+            large t = ah - qt * bh;
+            ah = bh;
+            bh = t;
+        }
+
+        if (B == 0)
+        {
+            // No certain quotient: perform one step of long division
+            limb_divmod(q, a, na, b, nb, mn);
+            std::swap(a, b);
+            for (size_t i = nb; i <= n; i++)
+                b[i] = 0;
+        }
+        else
+        {
+            lehmer_combine(ta, a, b, na, A, B);
+            lehmer_combine(tb, a, b, na, C, D);
+            for (size_t i = na + 1; i <= n; i++)
+                ta[i] = tb[i] = 0;
+            std::swap(a, ta);
+            std::swap(b, tb);
+        }
+        na = limb_size(a, n);
+        nb = limb_size(b, n);
+    }
+
+    // Finish with native integers
+    if (nb)
+    {
+        limb_divmod(q, a, na, b, nb, mn);
+        ularge av = a[0] | (nb > 1 ? ularge(a[1]) << 32 : 0);
+        ularge bv = b[0] | (nb > 1 ? ularge(b[1]) << 32 : 0);
+        ularge g  = bignum::gcd(av, bv);
+        for (size_t i = 0; i <= n; i++)
+            a[i] = 0;
+        a[0] = limb(g);
+        a[1] = limb(g >> 32);
+        na = limb_size(a, 2);
+    }
+    *size = na;
+    return a;
+}
+
+
+bignum_g bignum::gcd(bignum_r xr, bignum_r yr)
+// ----------------------------------------------------------------------------
+//   Compute the GCD of the magnitudes of two bignums
+// ----------------------------------------------------------------------------
+{
+    if (!xr || !yr)
+        return nullptr;
+    size_t xs = 0;
+    size_t ys = 0;
+    byte_p x  = xr->value(&xs);
+    byte_p y  = yr->value(&ys);
+    size_t n  = (std::max(xs, ys) + 3) / 4 + 1;
+    size_t scratch = 4 * n + sizeof(limb) + (6 * n + 4) * sizeof(limb);
+    byte *buffer = rt.allocate(scratch);      // May GC here
+    if (!buffer)
+        return nullptr;
+    x = xr->value(&xs);                       // Re-read after potential GC
+    y = yr->value(&ys);
+
+    limb *a  = limb_align(buffer + 4 * n);
+    limb *b  = a + n + 1;
+    limb_unpack(a, n, x, xs);
+    limb_unpack(b, n, y, ys);
+    size_t na = 0;
+    limb  *g  = limb_gcd(a, b, n, b + n + 1, &na);
+
+    size_t sz = limb_pack(buffer, 4 * n, g, na);
+    gcbytes buf = buffer;
+    bignum_g result = rt.make<bignum>(ID_bignum, buf, sz);
+    rt.free(scratch);
+    return result;
+}
+
+
 bignum_g operator/(bignum_r y, bignum_r x)
 // ----------------------------------------------------------------------------
 //   Perform long division of y by x
@@ -715,34 +1433,660 @@ bignum_g operator%(bignum_r y, bignum_r x)
 }
 
 
+static uint window_size(size_t bits)
+// ----------------------------------------------------------------------------
+//   Window size for sliding-window exponentiation with that many bits
+// ----------------------------------------------------------------------------
+{
+    return bits > 512 ? 5 : bits > 128 ? 4 : bits > 24 ? 3 : bits > 6 ? 2 : 1;
+}
+
+
+static inline uint exponent_bit(byte_p x, size_t bit)
+// ----------------------------------------------------------------------------
+//   Return the given bit of a little-endian exponent
+// ----------------------------------------------------------------------------
+{
+    return (x[bit / 8] >> (bit % 8)) & 1;
+}
+
+
+static size_t exponent_bits(byte_p x, size_t xs)
+// ----------------------------------------------------------------------------
+//   Return the number of significant bits in an exponent
+// ----------------------------------------------------------------------------
+{
+    while (xs > 0 && x[xs - 1] == 0)
+        xs--;
+    if (!xs)
+        return 0;
+    return 8 * xs - __builtin_clz(x[xs - 1]) + 24;
+}
+
+
+static size_t exponent_window(byte_p x, size_t bit, uint w, uint *value)
+// ----------------------------------------------------------------------------
+//   Find the longest window of at most w bits ending in 1, below bit
+// ----------------------------------------------------------------------------
+//   The top bit must be set. Return the window length, set the odd value.
+{
+    size_t len = std::min(size_t(w), bit + 1);
+    while (!exponent_bit(x, bit + 1 - len))
+        len--;
+    uint v = 0;
+    for (size_t i = 0; i < len; i++)
+        v = (v << 1) | exponent_bit(x, bit - i);
+    *value = v;
+    return len;
+}
+
+
 bignum_g bignum::pow(bignum_r yr, bignum_r xr)
 // ----------------------------------------------------------------------------
 //    Compute y^abs(x)
 // ----------------------------------------------------------------------------
 //   Note that the case where x is negative should be filtered by caller
+//   This uses left-to-right sliding windows, with the odd powers of y up to
+//   y^(2^w-1) computed ahead of time, so that the squarings operate on the
+//   result and at most one multiplication is needed per window.
 {
     if (!xr || !yr)
         return nullptr;
-    bignum_g r  = bignum::make(1);
-    size_t   xs = 0;
-    byte_p   x  = xr->value(&xs);
-    bignum_g y  = yr;
-    for (size_t xi = 0; xi < xs; xi++)
+    size_t xs   = 0;
+    byte_p x    = xr->value(&xs);
+    size_t bits = exponent_bits(x, xs);
+    if (!bits)
+        return bignum::make(1);
+
+    uint     w = window_size(bits);
+    bignum_g odd[16];
+    odd[0] = yr;
+    if (w > 1)
+    {
+        bignum_g y2 = yr * yr;
+        if (!y2)
+            return nullptr;
+        for (uint i = 1; i < (1U << (w - 1)); i++)
+            if (!(odd[i] = odd[i - 1] * y2))
+                return nullptr;
+    }
+
+    bignum_g r     = nullptr;
+    bool     first = true;
+    for (size_t bit = bits; bit-- > 0; )
+    {
+        x = xr->value(&xs);                   // Re-read after potential GC
+        if (!exponent_bit(x, bit))
+        {
+            r = r * r;
+        }
+        else
+        {
+            uint   v   = 0;
+            size_t len = exponent_window(x, bit, w, &v);
+            if (first)
+            {
+                r = odd[v / 2];
+                first = false;
+            }
+            else
+            {
+                for (size_t i = 0; i < len; i++)
+                    if (!(r = r * r))
+                        return nullptr;
+                r = r * odd[v / 2];
+            }
+            bit -= len - 1;
+        }
+        if (!r)
+            return nullptr;
+    }
+    return r;
+}
+
+
+static void montgomery_mul(limb *r, const limb *a, const limb *b,
+                           const limb *m, size_t k, limb minv, limb *t)
+// ----------------------------------------------------------------------------
+//   Compute a * b / 2^(32k) mod m, with t of size k + 2
+// ----------------------------------------------------------------------------
+//   This is the coarsely integrated operand scanning (CIOS) method, with
+//   minv = -1/m mod 2^32. The modulus must be odd, and a, b less than m.
+{
+    for (size_t i = 0; i < k + 2; i++)
+        t[i] = 0;
+    for (size_t i = 0; i < k; i++)
+    {
+        dlimb c  = 0;
+        dlimb ai = a[i];
+        for (size_t j = 0; j < k; j++)
+        {
+            c += ai * b[j] + t[j];
+            t[j] = limb(c);
+            c >>= 32;
+        }
+        c += t[k];
+        t[k] = limb(c);
+        t[k + 1] = limb(c >> 32);
+
+        dlimb q = limb(t[0] * minv);
+        c = (q * m[0] + t[0]) >> 32;
+        for (size_t j = 1; j < k; j++)
+        {
+            c += q * m[j] + t[j];
+            t[j - 1] = limb(c);
+            c >>= 32;
+        }
+        c += t[k];
+        t[k - 1] = limb(c);
+        t[k] = t[k + 1] + limb(c >> 32);
+    }
+    if (t[k] || limb_compare(t, k, m, k) >= 0)
+        limb_sub(t, m, k);
+    for (size_t i = 0; i < k; i++)
+        r[i] = t[i];
+}
+
+
+static limb montgomery_inverse(limb m0)
+// ----------------------------------------------------------------------------
+//   Compute -1/m0 mod 2^32 for an odd m0 using Newton's iteration
+// ----------------------------------------------------------------------------
+{
+    limb inv = 1;
+    for (uint i = 0; i < 5; i++)
+        inv *= 2 - m0 * inv;
+    return -inv;
+}
+
+
+bignum_g bignum::powmod(bignum_r xr, bignum_r er, bignum_r mr)
+// ----------------------------------------------------------------------------
+//   Compute x^e mod m without building x^e, for e >= 0 and m > 0
+// ----------------------------------------------------------------------------
+//   The result is in [0, m) like MOD. The computation is done on limbs with
+//   sliding-window exponentiation. For an odd modulus, values are kept in
+//   Montgomery form, which avoids divisions. For an even modulus, each
+//   product is reduced with long division.
+{
+    if (!xr || !er || !mr)
+        return nullptr;
+    if (mr->is_zero())
+    {
+        rt.zero_divide_error();
+        return nullptr;
+    }
+
+    size_t xs    = 0;
+    size_t es    = 0;
+    size_t ms    = 0;
+    byte_p x     = xr->value(&xs);
+    byte_p e     = er->value(&es);
+    byte_p m     = mr->value(&ms);
+    size_t bits  = exponent_bits(e, es);
+    size_t nx    = (xs + 3) / 4;
+    size_t k     = (ms + 3) / 4;
+    uint   w     = window_size(bits);
+    size_t nt    = std::max(nx + k, 2 * k) + 2;
+    size_t nodd  = size_t(1) << (w - 1);
+    size_t scratch = 4 * k + sizeof(limb)
+        + (k + 2 * nt + k + k + nodd * k + k) * sizeof(limb);
+    byte *buffer = rt.allocate(scratch);      // May GC here
+    if (!buffer)
+        return nullptr;
+    x = xr->value(&xs);                       // Re-read after potential GC
+    e = er->value(&es);
+    m = mr->value(&ms);
+
+    limb *ml  = limb_align(buffer + 4 * k);
+    limb *t   = ml + k;                       // Products, nt limbs
+    limb *q   = t + nt;                       // Quotients, nt limbs
+    limb *mn  = q + nt;                       // Normalized modulus
+    limb *x2  = mn + k;                       // x^2
+    limb *odd = x2 + k;                       // Odd powers of x
+    limb *r   = odd + nodd * k;               // Result
+    limb_unpack(ml, k, m, ms);
+    k = limb_size(ml, k);
+
+    // Reduce x modulo m, and convert to Montgomery form if m is odd
+    bool  mont = ml[0] & 1;
+    limb  minv = 0;
+    limb_unpack(t, nt, x, xs);
+    if (mont)
+    {
+        minv = montgomery_inverse(ml[0]);
+
+        // x * 2^(32k) mod m
+        for (size_t i = nx + 1; i-- > 0; )
+            t[i + k] = t[i];
+        for (size_t i = 0; i < k; i++)
+            t[i] = 0;
+        nx += k;
+    }
+    if (nx >= k)
+        limb_divmod(q, t, nx, ml, k, mn);
+    for (size_t i = 0; i < k; i++)
+        odd[i] = t[i];
+
+    // Modular product of a and b into r
+    auto mulmod = [&](limb *res, const limb *a, const limb *b)
+    {
+        if (mont)
+        {
+            montgomery_mul(res, a, b, ml, k, minv, t);
+        }
+        else
+        {
+            limb_mul(t, a, k, b, k);
+            limb_divmod(q, t, 2 * k, ml, k, mn);
+            for (size_t i = 0; i < k; i++)
+                res[i] = t[i];
+        }
+    };
+
+    // Precompute odd powers of x
+    if (w > 1)
+    {
+        mulmod(x2, odd, odd);
+        for (size_t i = 1; i < nodd; i++)
+            mulmod(odd + i * k, odd + (i - 1) * k, x2);
+    }
+
+    // The value 1, in Montgomery form if needed
+    for (size_t i = 0; i < nt; i++)
+        t[i] = 0;
+    t[mont ? k : 0] = 1;
+    limb_divmod(q, t, mont ? k + 1 : k, ml, k, mn);
+    for (size_t i = 0; i < k; i++)
+        r[i] = t[i];
+
+    // Left-to-right sliding window exponentiation
+    for (size_t bit = bits; bit-- > 0; )
     {
-        byte xv = x[xi];
-        for (uint bit = 0; (xv || xi+1 < xs) && bit < 8; bit++)
+        if (!exponent_bit(e, bit))
+        {
+            mulmod(r, r, r);
+        }
+        else
         {
-            if (xv & 1)
-                r = r * y;
-            xv >>= 1;
-            if (xv || xi < xs-1)
-                y = y * y;
+            uint   v   = 0;
+            size_t len = exponent_window(e, bit, w, &v);
+            for (size_t i = 0; i < len; i++)
+                mulmod(r, r, r);
+            mulmod(r, r, odd + v / 2 * k);
+            bit -= len - 1;
         }
     }
+
+    // Convert back from Montgomery form, multiplying by 1
+    if (mont)
+    {
+        for (size_t i = 0; i < k; i++)
+            x2[i] = i == 0;
+        mulmod(r, r, x2);
+    }
+
+    // For negative x and odd e, the result is m - |x|^e mod m
+    bool neg = xr->type() == ID_neg_bignum && bits && exponent_bit(e, 0);
+    if (neg && limb_size(r, k))
+    {
+        for (size_t i = 0; i < k; i++)
+            t[i] = ml[i];
+        limb_sub(t, r, k);
+        for (size_t i = 0; i < k; i++)
+            r[i] = t[i];
+    }
+
+    size_t sz = limb_pack(buffer, 4 * k, r, k);
+    gcbytes buf = buffer;
+    bignum_g result = rt.make<bignum>(ID_bignum, buf, sz);
+    rt.free(scratch);
+    return result;
+}
+
+
+// ============================================================================
+//
+//   Primality and factorization
+//
+// ============================================================================
+
+static const byte small_primes[] =
+// ----------------------------------------------------------------------------
+//   Primes below 256, used for trial division and as Miller-Rabin bases
+// ----------------------------------------------------------------------------
+{
+      2,   3,   5,   7,  11,  13,  17,  19,  23,  29,  31,  37,  41,  43,
+     47,  53,  59,  61,  67,  71,  73,  79,  83,  89,  97, 101, 103, 107,
+    109, 113, 127, 131, 137, 139, 149, 151, 157, 163, 167, 173, 179, 181,
+    191, 193, 197, 199, 211, 223, 227, 229, 233, 239, 241, 251
+};
+
+
+static uint small_mod(byte_p x, size_t xs, uint p)
+// ----------------------------------------------------------------------------
+//   Remainder of the little-endian bytes of x modulo a small value
+// ----------------------------------------------------------------------------
+{
+    uint r = 0;
+    for (size_t i = xs; i-- > 0; )
+        r = (r * 256 + x[i]) % p;
     return r;
 }
 
 
+struct montgomery
+// ----------------------------------------------------------------------------
+//   Montgomery arithmetic modulo an odd value of k limbs
+// ----------------------------------------------------------------------------
+//   Values are kept in Montgomery form, i.e. x is represented as x*R mod m
+//   with R = 2^(32k). Work areas t and u have k+2 limbs, q has 2, mn has k.
+{
+    montgomery(const limb *m, size_t k, limb *work)
+        : m(m), k(k), minv(montgomery_inverse(m[0])),
+          t(work), u(t + k + 2), q(u + k + 2), mn(q + 2) {}
+
+    static size_t work_size(size_t k)   { return 3 * k + 6; }
+
+    void mul(limb *r, const limb *a, const limb *b)
+    {
+        montgomery_mul(r, a, b, m, k, minv, t);
+    }
+
+    void from(limb *r, limb v)
+    {
+        // Compute v * R mod m
+        for (size_t i = 0; i < k + 2; i++)
+            u[i] = 0;
+        u[k] = v;
+        limb_divmod(q, u, k + 1, m, k, mn);
+        for (size_t i = 0; i < k; i++)
+            r[i] = u[i];
+    }
+
+    void add(limb *r, const limb *a)
+    {
+        // Compute r + a mod m, where r has room for k + 1 limbs
+        r[k] = limb_add(r, a, k);
+        if (r[k] || limb_compare(r, k, m, k) >= 0)
+            limb_sub(r, m, k);
+    }
+
+    void distance(limb *r, const limb *a, const limb *b)
+    {
+        // Compute |a - b|
+        if (limb_compare(a, k, b, k) < 0)
+            std::swap(a, b);
+        for (size_t i = 0; i < k; i++)
+            r[i] = a[i];
+        limb_sub(r, b, k);
+    }
+
+    bool equal(const limb *a, const limb *b)
+    {
+        for (size_t i = 0; i < k; i++)
+            if (a[i] != b[i])
+                return false;
+        return true;
+    }
+
+    const limb *m;
+    size_t      k;
+    limb        minv;
+    limb       *t;
+    limb       *u;
+    limb       *q;
+    limb       *mn;
+};
+
+
+static bool miller_rabin(montgomery &mg, const limb *one, const limb *mone,
+                         limb base, limb *x, limb *y)
+// ----------------------------------------------------------------------------
+//   Check if the modulus is a strong probable prime to the given base
+// ----------------------------------------------------------------------------
+//   With n - 1 = d * 2^s and d odd, n passes if base^d = 1 or if
+//   base^(d * 2^r) = -1 for some r < s. Since n is odd, the bits of n - 1
+//   other than bit 0 are those of n.
+{
+    const limb *n    = mg.m;
+    size_t      k    = mg.k;
+    size_t      bits = 32 * k - __builtin_clz(n[k - 1]);
+    auto        bit  = [n](size_t b) { return (n[b / 32] >> (b % 32)) & 1; };
+    size_t      s    = 1;
+    while (!bit(s))
+        s++;
+
+    mg.from(x, base);
+    for (size_t i = 0; i < k; i++)
+        y[i] = x[i];
+    for (size_t b = bits - 1; b-- > s; )
+    {
+        mg.mul(y, y, y);
+        if (bit(b))
+            mg.mul(y, y, x);
+    }
+    if (mg.equal(y, one) || mg.equal(y, mone))
+        return true;
+    for (size_t r = 1; r < s; r++)
+    {
+        mg.mul(y, y, y);
+        if (mg.equal(y, mone))
+            return true;
+        if (mg.equal(y, one))
+            return false;
+    }
+    return false;
+}
+
+
+bool bignum::is_prime(bignum_r xr, bool *prime)
+// ----------------------------------------------------------------------------
+//   Check if the magnitude of x is prime, return false if interrupted
+// ----------------------------------------------------------------------------
+//   Values below 2^16 are checked by trial division. Other values are first
+//   checked for small factors, then with the Miller-Rabin test. The first
+//   12 prime bases are sufficient to make the test deterministic for any
+//   value below 2^64. Larger values also get 12 pseudo-random bases, which
+//   bounds the probability of a composite passing to 2^-48.
+{
+    *prime = false;
+    if (!xr)
+        return false;
+
+    size_t xs = 0;
+    byte_p x  = xr->value(&xs);
+    uint   v  = (xs > 0 ? x[0] : 0) | (xs > 1 ? x[1] << 8 : 0);
+    for (uint p : small_primes)
+    {
+        if (xs <= 2 && p * p > v)
+        {
+            *prime = v >= 2;
+            return true;
+        }
+        if (small_mod(x, xs, p) == 0)
+            return true;
+    }
+    if (xs <= 2)
+    {
+        *prime = true;
+        return true;
+    }
+
+    size_t k       = (xs + 3) / 4;
+    size_t scratch = sizeof(limb)
+        + (k + montgomery::work_size(k) + 4 * k) * sizeof(limb);
+    byte *buffer   = rt.allocate(scratch);    // May GC here
+    if (!buffer)
+        return false;
+    x = xr->value(&xs);                       // Re-read after potential GC
+
+    limb *n    = limb_align(buffer);
+    limb *work = n + k;
+    limb *one  = work + montgomery::work_size(k);
+    limb *mone = one + k;
+    limb *y    = mone + k;
+    limb *z    = y + k;
+    limb_unpack(n, k, x, xs);
+    k = limb_size(n, k);
+
+    montgomery mg(n, k, work);
+    mg.from(one, 1);
+    for (size_t i = 0; i < k; i++)
+        mone[i] = n[i];
+    limb_sub(mone, one, k);
+
+    bool   ok     = true;
+    uint   rounds = k > 2 ? 24 : 12;
+    limb   seed   = n[0] ^ limb(k * 0x9E3779B9);
+    *prime = true;
+    for (uint r = 0; *prime && r < rounds; r++)
+    {
+        if (program::interrupted())
+        {
+            rt.interrupted_error();
+            ok = false;
+            break;
+        }
+        limb base = small_primes[r];
+        if (r >= 12)
+        {
+            // Pseudo-random bases, with xorshift32
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            base = 2 + seed % 0xFFFFFFF0U;
+        }
+        *prime = miller_rabin(mg, one, mone, base, y, z);
+    }
+    rt.free(scratch);
+    return ok;
+}
+
+
+bignum_g bignum::factor(bignum_r xr)
+// ----------------------------------------------------------------------------
+//   Return a non-trivial factor of a composite x, nullptr if interrupted
+// ----------------------------------------------------------------------------
+//   Small prime factors are found by trial division. Otherwise, Brent's
+//   variant of Pollard's rho algorithm iterates y -> y^2 + c modulo n,
+//   in Montgomery form, until the GCD of n and the accumulated product
+//   of the distances |x - y| is non-trivial. The GCD is computed only
+//   once every 128 steps. If it overshoots to n, the last batch is
+//   replayed one step at a time, and if this still fails, another c
+//   is tried.
+{
+    if (!xr)
+        return nullptr;
+
+    size_t xs = 0;
+    byte_p x  = xr->value(&xs);
+    for (uint p : small_primes)
+        if (small_mod(x, xs, p) == 0)
+            return rt.make<bignum>(ID_bignum, ularge(p));
+
+    const size_t m       = 128;
+    size_t       k       = (xs + 3) / 4;
+    size_t       gn      = k + 1;
+    size_t       scratch = 4 * k + sizeof(limb)
+        + (k + montgomery::work_size(k) + 6 * k + 3
+           + 2 * (gn + 1) + 4 * gn + 2) * sizeof(limb);
+    byte *buffer = rt.allocate(scratch);      // May GC here
+    if (!buffer)
+        return nullptr;
+    x = xr->value(&xs);                       // Re-read after potential GC
+
+    limb *n    = limb_align(buffer + 4 * k);
+    limb *work = n + k;
+    limb *c    = work + montgomery::work_size(k);
+    limb *xv   = c + k;
+    limb *y    = xv + k + 1;
+    limb *ys   = y + k + 1;
+    limb *prod = ys + k + 1;
+    limb *dist = prod + k;
+    limb *ga   = dist + k;
+    limb *gb   = ga + gn + 1;
+    limb *gw   = gb + gn + 1;
+    limb_unpack(n, k, x, xs);
+    k = limb_size(n, k);
+
+    montgomery mg(n, k, work);
+    limb      *g  = nullptr;
+    size_t     gs = 0;
+
+    // Compute the GCD of n and v
+    auto gcd = [&](const limb *v)
+    {
+        for (size_t i = 0; i < gn; i++)
+        {
+            ga[i] = i < k ? v[i] : 0;
+            gb[i] = i < k ? n[i] : 0;
+        }
+        g = limb_gcd(ga, gb, gn, gw, &gs);
+        return gs == 1 && g[0] == 1;
+    };
+    auto step = [&](limb *v)
+    {
+        mg.mul(v, v, v);
+        mg.add(v, c);
+    };
+
+    bool found = false;
+    for (limb cv = 1; !found; cv++)
+    {
+        mg.from(c, cv);
+        mg.from(y, 2);
+        mg.from(prod, 1);
+        bool   trivial = true;
+        size_t r       = 1;
+        while (trivial)
+        {
+            for (size_t i = 0; i < k; i++)
+                xv[i] = y[i];
+            for (size_t i = 0; i < r; i++)
+                step(y);
+            for (size_t done = 0; done < r && trivial; done += m)
+            {
+                if (program::interrupted())
+                {
+                    rt.interrupted_error();
+                    rt.free(scratch);
+                    return nullptr;
+                }
+                for (size_t i = 0; i < k; i++)
+                    ys[i] = y[i];
+                size_t count = std::min(m, r - done);
+                for (size_t i = 0; i < count; i++)
+                {
+                    step(y);
+                    mg.distance(dist, xv, y);
+                    mg.mul(prod, prod, dist);
+                }
+                trivial = gcd(prod);
+            }
+            r *= 2;
+        }
+
+        // If we overshot to n, retry the last batch one step at a time
+        if (limb_compare(g, gs, n, k) == 0)
+        {
+            do
+            {
+                step(ys);
+                mg.distance(dist, xv, ys);
+            } while (gcd(dist));
+        }
+        found = limb_compare(g, gs, n, k) != 0;
+    }
+
+    size_t sz = limb_pack(buffer, 4 * k, g, gs);
+    gcbytes buf = buffer;
+    bignum_g result = rt.make<bignum>(ID_bignum, buf, sz);
+    rt.free(scratch);
+    return result;
+}
+
+
 static size_t fraction_render(big_fraction_p o, renderer &r, bool negative)
 // ----------------------------------------------------------------------------
 //   Common code for positive and negative fractions
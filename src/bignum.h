@@ -188,6 +188,14 @@ public:
     static bignum_g multiply(bignum_r y, bignum_r x, id ty);
     static bool quorem(bignum_r y, bignum_r x, id ty, bignum_g *q, bignum_g *r);
     static bignum_g pow(bignum_r y, bignum_r x);
+    static bignum_g powmod(bignum_r x, bignum_r e, bignum_r m);
+    static bignum_g gcd(bignum_r x, bignum_r y);
+    static ularge   gcd(ularge x, ularge y);
+    static bool     is_prime(bignum_r x, bool *prime);
+    static bignum_g factor(bignum_r x);
+    static bignum_g from_digits(id ty, uint base, ularge high,
+                                gcutf8 digits, size_t count);
+    static text_g   to_digits(bignum_r x, uint base);
     static bignum_p shift(bignum_r x, int bits, bool rotate, bool arith);
 
 public:
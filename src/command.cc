@@ -59,6 +59,63 @@ RECORDER(command,       16, "RPL Commands");
 RECORDER(command_error, 16, "Errors processing a command");
 
 
+// Command spellings, grouped by first byte (ignoring ASCII case)
+static uint16_t *spelling_index = nullptr;
+static uint16_t  spelling_start[257];
+static const uint16_t SPELLING_NEW_TYPE = 0x8000;
+
+
+static bool initialize_spelling_index()
+// ----------------------------------------------------------------------------
+//   Build the first-byte index of command spellings
+// ----------------------------------------------------------------------------
+//   Within each group, spellings are kept in the original order, so that the
+//   first match is the same as with a linear search of the spellings.
+//   Entries for the first spelling of a type are tagged with SPELLING_NEW_TYPE
+{
+    const object::spelling *spellings  = object::spellings;
+    size_t                  count      = object::spelling_count;
+    uint                    sizes[256] = { 0 };
+    uint                    total      = 0;
+
+    for (size_t i = 0; i < count; i++)
+        if (object::is_command(spellings[i].type))
+            if (cstring name = spellings[i].name)
+                if (*name)
+                    sizes[tolower(byte(*name))]++, total++;
+
+    spelling_index = (uint16_t *) realloc(spelling_index,
+                                          total * sizeof(uint16_t));
+    if (!spelling_index)
+        return false;
+
+    spelling_start[0] = 0;
+    for (uint b = 0; b < 256; b++)
+        spelling_start[b + 1] = spelling_start[b] + sizes[b];
+    for (uint b = 0; b < 256; b++)
+        sizes[b] = spelling_start[b];
+
+    object::id type = object::id(0);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!object::is_command(spellings[i].type))
+            continue;
+        if (cstring name = spellings[i].name)
+        {
+            uint16_t entry = i;
+            if (type != spellings[i].type)
+            {
+                type = spellings[i].type;
+                entry |= SPELLING_NEW_TYPE;
+            }
+            if (*name)
+                spelling_index[sizes[tolower(byte(*name))]++] = entry;
+        }
+    }
+    return true;
+}
+
+
 PARSE_BODY(command)
 // ----------------------------------------------------------------------------
 //    Try to parse this as a command, using either short or long name
@@ -69,44 +126,47 @@ PARSE_BODY(command)
     if (i != ID_Drop)
         return SKIP;
 
+    if (!spelling_index && !initialize_spelling_index())
+    {
+        rt.out_of_memory_error();
+        return ERROR;
+    }
+
     bool    eq     = p.precedence;
-    id      type   = id(0);
     id      found  = id(0);
     cstring ref    = cstring(utf8(p.source));
     size_t  maxlen = p.length;
     size_t  len    = maxlen;
+    uint    first  = tolower(byte(*ref));
 
-    for (size_t i = 0; i < spelling_count; i++)
+    // Only check the spellings that begin with the same character
+    for (uint s = spelling_start[first]; s < spelling_start[first+1]; s++)
     {
-        if (!is_command(spellings[i].type))
-            continue;
-        if (cstring cmd = spellings[i].name)
-        {
-            if (type != spellings[i].type)
-            {
-                type = spellings[i].type;
-
-                // When parsing an equation, parse x³ as cubed(x)
-                if (eq && (type == ID_sq || type == ID_cubed || type == ID_inv))
-                    continue;
-            }
-
-            // No function names like `min` while parsing units
-            if (unit::mode && is_valid_as_name_initial(utf8(cmd)))
+        uint16_t entry = spelling_index[s];
+        uint     index = entry & ~SPELLING_NEW_TYPE;
+        id       type  = spellings[index].type;
+        cstring  cmd   = spellings[index].name;
+
+        // When parsing an equation, parse x³ as cubed(x)
+        if (entry & SPELLING_NEW_TYPE)
+            if (eq && (type == ID_sq || type == ID_cubed || type == ID_inv))
                 continue;
 
-            len = strlen(cmd);
-            if (len <= maxlen
-                && strncasecmp(ref, cmd, len) == 0
-                && (len >= maxlen
-                    || (eq && (!is_valid_as_name_initial(utf8(cmd)) ||
-                               ((ref[len] < '0' || ref[len] > '9') &&
-                                !is_valid_as_name_initial(utf8(ref + len)))))
-                    || is_separator(utf8(ref + len))))
-            {
-                found = type;
-                break;
-            }
+        // No function names like `min` while parsing units
+        if (unit::mode && is_valid_as_name_initial(utf8(cmd)))
+            continue;
+
+        len = strlen(cmd);
+        if (len <= maxlen
+            && strncasecmp(ref, cmd, len) == 0
+            && (len >= maxlen
+                || (eq && (!is_valid_as_name_initial(utf8(cmd)) ||
+                           ((ref[len] < '0' || ref[len] > '9') &&
+                            !is_valid_as_name_initial(utf8(ref + len)))))
+                || is_separator(utf8(ref + len))))
+        {
+            found = type;
+            break;
         }
     }
 
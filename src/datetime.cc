@@ -31,6 +31,8 @@
 
 #include "arithmetic.h"
 #include "dmcp.h"
+#include "integer.h"
+#include "program.h"
 #include "renderer.h"
 #include "tag.h"
 #include "unit.h"
@@ -950,3 +952,44 @@ COMMAND_BODY(TimedEval)
                         return OK;
     return ERROR;
 }
+
+
+COMMAND_BODY(TimedParse)
+// ----------------------------------------------------------------------------
+//   Parse a text repeatedly and return the parsing throughput
+// ----------------------------------------------------------------------------
+//   The text is parsed as a command line for about one second, and the
+//   result is returned in megabytes of source text per second.
+{
+    text_g source = rt.top()->as<text>();
+    if (!source)
+    {
+        rt.type_error();
+        return ERROR;
+    }
+
+    uint   start    = sys_current_ms();
+    uint   duration = 0;
+    size_t parsed   = 0;
+    do
+    {
+        size_t    len  = 0;
+        utf8      txt  = source->value(&len);
+        program_g prog = program::parse(txt, len);
+        if (!prog)
+            return ERROR;
+        parsed += len;
+        duration = sys_current_ms() - start;
+    } while (duration < 1000 && !program::interrupted());
+
+    if (!duration)
+        duration = 1;
+    algebraic_g rate = integer::make(parsed);
+    algebraic_g time = integer::make(duration * 1000ULL);
+    rate = rate / time;
+    if (rate && algebraic::to_decimal(rate))
+        if (tag_g tval = tag::make("MB/s", +rate))
+            if (rt.top(+tval))
+                return OK;
+    return ERROR;
+}
@@ -83,6 +83,7 @@ COMMAND_DECLARE(SetTime,1);     // Set current time
 COMMAND_DECLARE(DateTime,0);    // Return current date and time
 COMMAND_DECLARE(ChronoTime,0);  // Return current date and time
 COMMAND_DECLARE(TimedEval,1);   // Timed evaluation
+COMMAND_DECLARE(TimedParse,1);  // Parsing throughput
 
 // HMS and DMS operations
 COMMAND_DECLARE(ToHMS,1);       // Convert from decimal to H:MM:SS format
@@ -37,6 +37,7 @@
 #include "settings.h"
 #include "utf8.h"
 
+#include <algorithm>
 #include <inttypes.h>
 
 
@@ -1518,11 +1519,18 @@ decimal_p decimal::add(decimal_r x, decimal_r y)
     if (rs < kshift)
         return lt ? y : x;
 
-    // Allocate the mantissa
+    // Allocate the mantissa after unpacked copies of the inputs, so that
+    // we can extend it if there is a carry
+    xs = std::min(xs, rs);
+    ys = std::min(ys, rs);
     scribble scr;
-    kint    *rb = (kint *) rt.allocate(rs * sizeof(kint));
-    if (!rb)
+    kint    *xp = (kint *) rt.allocate((xs + ys + rs) * sizeof(kint));
+    if (!xp)
         return nullptr;
+    kint    *yp = xp + xs;
+    kint    *rb = yp + ys;
+    unpack(xp, +xb, xs);
+    unpack(yp, +yb, ys);
 
     // Addition loop
     kint   hmul  = mod3 == 2 ? 100 : mod3 == 1 ? 10 : 1;
@@ -1531,15 +1539,15 @@ decimal_p decimal::add(decimal_r x, decimal_r y)
     size_t ko    = rs;
     while (ko-- > 0)
     {
-        kint xk = ko < xs ? kigit(+xb, ko) : 0;
+        kint xk = ko < xs ? xp[ko] : 0;
         kint yk = carry;
         if (ko >= kshift)
         {
             size_t yo = ko - kshift;
             if (yo < ys)
-                yk += kigit(+yb, yo) / hmul;
+                yk += yp[yo] / hmul;
             if (mod3 && ko > kshift && --yo < ys)
-                yk += kigit(+yb, yo) % hmul * lmul;
+                yk += yp[yo] % hmul * lmul;
         }
         xk += yk;
         carry = xk >= 1000;
@@ -1630,11 +1638,17 @@ decimal_p decimal::sub(decimal_r x, decimal_r y)
     if (rs < kshift)
         return lt ? neg(y) : decimal_p(x);
 
-    // Allocate the mantissa
+    // Allocate the mantissa and unpacked copies of the inputs
+    xs = std::min(xs, rs);
+    ys = std::min(ys, rs);
     scribble scr;
-    kint    *rb = (kint *) rt.allocate(rs * sizeof(kint));
-    if (!rb)
+    kint    *xp = (kint *) rt.allocate((xs + ys + rs) * sizeof(kint));
+    if (!xp)
         return nullptr;
+    kint    *yp = xp + xs;
+    kint    *rb = yp + ys;
+    unpack(xp, +xb, xs);
+    unpack(yp, +yb, ys);
 
     // Subtraction loop
     kint   hmul  = mod3 == 2 ? 100 : mod3 == 1 ? 10 : 1;
@@ -1643,15 +1657,15 @@ decimal_p decimal::sub(decimal_r x, decimal_r y)
     size_t ko    = rs;
     while (ko-- > 0)
     {
-        kint xk = ko < xs ? kigit(+xb, ko) : 0;
+        kint xk = ko < xs ? xp[ko] : 0;
         kint yk = carry;
         if (ko >= kshift)
         {
             size_t yo = ko - kshift;
             if (yo < ys)
-                yk += kigit(+yb, yo) / hmul;
+                yk += yp[yo] / hmul;
             if (mod3 && ko > kshift && --yo < ys)
-                yk += kigit(+yb, yo) % hmul * lmul;
+                yk += yp[yo] % hmul * lmul;
         }
         carry = xk < yk;
         if (carry)
@@ -1688,12 +1702,120 @@ decimal_p decimal::sub(decimal_r x, decimal_r y)
 }
 
 
+// Below this number of kigits, schoolbook multiplication is faster
+static const size_t KARATSUBA_THRESHOLD = 32;
+
+
+static size_t karatsuba_space(size_t n)
+// ----------------------------------------------------------------------------
+//   Workspace required by karatsuba() for n-kigit operands
+// ----------------------------------------------------------------------------
+{
+    if (n < KARATSUBA_THRESHOLD)
+        return 0;
+    size_t l = n - n / 2;
+    return 4 * l + karatsuba_space(l);
+}
+
+
+static void karatsuba(large *r, const large *a, const large *b, size_t n,
+                      large *ws)
+// ----------------------------------------------------------------------------
+//   Compute the 2n column sums of the product of two n-kigit operands
+// ----------------------------------------------------------------------------
+//   Column sums are not carried, so that the caller can drop columns
+//   exactly like schoolbook multiplication does. With a = a0 + X^h a1
+//   and b = b0 + X^h b1, we compute z0 = a0*b0, z2 = a1*b1 and
+//   z1 = (a0+a1)*(b0+b1) - z0 - z2, and a*b = z0 + X^h z1 + X^2h z2
+{
+    if (n < KARATSUBA_THRESHOLD)
+    {
+        for (size_t i = 0; i < 2 * n; i++)
+            r[i] = 0;
+        for (size_t i = 0; i < n; i++)
+            for (size_t j = 0; j < n; j++)
+                r[i + j] += a[i] * b[j];
+        return;
+    }
+
+    size_t h  = n / 2;
+    size_t l  = n - h;
+    large *sa = ws;
+    large *sb = sa + l;
+    large *z1 = sb + l;
+    karatsuba(r, a, b, h, ws);
+    karatsuba(r + 2 * h, a + h, b + h, l, ws);
+    for (size_t i = 0; i < l; i++)
+    {
+        sa[i] = a[h + i] + (i < h ? a[i] : 0);
+        sb[i] = b[h + i] + (i < h ? b[i] : 0);
+    }
+    karatsuba(z1, sa, sb, l, z1 + 2 * l);
+    for (size_t i = 0; i < 2 * h; i++)
+        z1[i] -= r[i];
+    for (size_t i = 0; i < 2 * l; i++)
+        z1[i] -= r[2 * h + i];
+    for (size_t i = 0; i < 2 * l; i++)
+        r[h + i] += z1[i];
+}
+
+
+static size_t mulders_space(size_t n)
+// ----------------------------------------------------------------------------
+//   Workspace required by mulders() for n-kigit operands
+// ----------------------------------------------------------------------------
+{
+    if (n < KARATSUBA_THRESHOLD)
+        return 0;
+    size_t k = n - n / 2;
+    size_t l = n - k;
+    return std::max(2 * k + karatsuba_space(k), l + mulders_space(l));
+}
+
+
+static void mulders(large *r, const large *a, const large *b, size_t n,
+                    large *ws)
+// ----------------------------------------------------------------------------
+//   Compute the n high column sums of the product of two n-kigit operands
+// ----------------------------------------------------------------------------
+//   This is a short product, which only computes terms a[i]*b[j] for
+//   i+j < n. The top k kigits of each operand are multiplied with
+//   karatsuba(), the remaining terms are two short products of size n-k.
+{
+    if (n < KARATSUBA_THRESHOLD)
+    {
+        for (size_t i = 0; i < n; i++)
+            r[i] = 0;
+        for (size_t i = 0; i < n; i++)
+            for (size_t j = 0; i + j < n; j++)
+                r[i + j] += a[i] * b[j];
+        return;
+    }
+
+    size_t k = n - n / 2;
+    size_t l = n - k;
+    karatsuba(ws, a, b, k, ws + 2 * k);
+    for (size_t i = 0; i < n; i++)
+        r[i] = ws[i];
+    mulders(ws, a + k, b, l, ws + l);
+    for (size_t i = 0; i < l; i++)
+        r[k + i] += ws[i];
+    mulders(ws, a, b + k, l, ws + l);
+    for (size_t i = 0; i < l; i++)
+        r[k + i] += ws[i];
+}
+
+
 decimal_p decimal::mul(decimal_r x, decimal_r y)
 // ----------------------------------------------------------------------------
 //   Multiplication of two decimal numbers
 // ----------------------------------------------------------------------------
 //  (a0+a1/1000) * (b0+b1/1000) = a0*b0 + (a0*b1+a1*b0) / 1000 + epsilon
-//  Exponent is the sum of the two exponents
+//  Exponent is the sum of the two exponents.
+//  Products landing beyond the result size are dropped, so we first
+//  compute the sum of products for each result kigit, then carry.
+//  Large operands use Karatsuba multiplication for these column sums,
+//  with a short product when the result is truncated.
 {
     if (!x || !y)
         return nullptr;
@@ -1718,40 +1840,90 @@ decimal_p decimal::mul(decimal_r x, decimal_r y)
     size_t   ps  = (Settings.Precision() + 2) / 3;
     size_t   rs  = std::min(ps, xs + ys + 1);
 
-    // Allocate the mantissa
+    // Select the algorithm, Karatsuba operands are padded to size ks
+    xs = std::min(xs, rs);
+    ys = std::min(ys, rs);
+    bool     full = xs + ys <= rs + 1;
+    size_t   ks   = 0;
+    size_t   ls   = rs;
+    if (std::min(xs, ys) >= KARATSUBA_THRESHOLD)
+    {
+        // Full products slice the longer operand in chunks of the size of
+        // the shorter one, so that unbalanced operands are not zero-padded
+        ks = full ? std::min(xs, ys) : rs;
+        ls = full ? rs + 4 * ks + karatsuba_space(ks)
+                  : 3 * ks + mulders_space(ks);
+    }
+
+    // Allocate the mantissa, unpacked inputs and aligned column sums
+    size_t   kb = (xs + ys + rs) * sizeof(kint);
     scribble scr;
-    kint    *rb = (kint *) rt.allocate(rs * sizeof(kint));
-    if (!rb)
+    kint    *xp = (kint *) rt.allocate(kb + (ls + 1) * sizeof(large));
+    if (!xp)
         return nullptr;
-
-    // Zero the result before doing sums on it
-    for (size_t ri = 0; ri < rs; ri++)
-        rb[ri] = 0;
-
-    // Sum on all digits
-    uint carry = 0;
-    for (size_t xi = 0; xi < xs; xi++)
+    kint    *yp = xp + xs;
+    kint    *rb = yp + ys;
+    large   *cp = (large *) ((uintptr_t(rb + rs) + sizeof(large) - 1)
+                             & ~uintptr_t(sizeof(large) - 1));
+    unpack(xp, +xb, xs);
+    unpack(yp, +yb, ys);
+
+    // Sum the products for each kigit of the result
+    if (ks && full)
     {
-        kint xk = kigit(xb, xi);
-        for (size_t yi = 0; yi < ys; yi++)
+        bool    xlong = xs >= ys;
+        kint   *lp    = xlong ? xp : yp;
+        kint   *sp    = xlong ? yp : xp;
+        size_t  ln    = xlong ? xs : ys;
+        large  *ap    = cp + rs;
+        large  *bp    = ap + ks;
+        large  *zp    = bp + ks;
+        for (size_t ri = 0; ri < rs; ri++)
+            cp[ri] = 0;
+        for (size_t i = 0; i < ks; i++)
+            ap[i] = sp[i];
+        for (size_t off = 0; off < ln; off += ks)
         {
-            size_t ri = xi + yi;
-            if (ri >= rs)
-                break;
-            kint yk = kigit(yb, yi);
-            uint rk = xk * yk;
-            while (rk)
-            {
-                rk += rb[ri];
-                rb[ri] = rk % 1000;
-                rk /= 1000;
-                if (ri-- == 0)
-                    break;
-            }
-            carry += rk;
+            for (size_t i = 0; i < ks; i++)
+                bp[i] = off + i < ln ? lp[off + i] : 0;
+            karatsuba(zp, ap, bp, ks, zp + 2 * ks);
+            for (size_t i = 0; i < 2 * ks && off + i < rs; i++)
+                cp[off + i] += zp[i];
+        }
+    }
+    else if (ks)
+    {
+        large *ap = cp + ks;
+        large *bp = ap + ks;
+        for (size_t i = 0; i < ks; i++)
+        {
+            ap[i] = i < xs ? xp[i] : 0;
+            bp[i] = i < ys ? yp[i] : 0;
+        }
+        mulders(cp, ap, bp, ks, bp + ks);
+    }
+    else
+    {
+        for (size_t ri = 0; ri < rs; ri++)
+            cp[ri] = 0;
+        for (size_t xi = 0; xi < xs; xi++)
+        {
+            large xk = xp[xi];
+            for (size_t yi = 0; yi < ys && xi + yi < rs; yi++)
+                cp[xi + yi] += xk * yp[yi];
         }
     }
 
+    // Propagate carries
+    large sum = 0;
+    for (size_t ri = rs; ri --> 0; )
+    {
+        sum += cp[ri];
+        rb[ri] = sum % 1000;
+        sum /= 1000;
+    }
+    uint carry = sum;
+
     // Check if a carry remains above top
     while (carry)
     {
@@ -1805,6 +1977,10 @@ decimal_p decimal::mul(decimal_r x, decimal_r y)
 }
 
 
+// Above this number of kigits in the divisor, use Newton-Raphson division
+static const size_t NEWTON_DIVISION_THRESHOLD = 28;
+
+
 decimal_p decimal::div(decimal_r x, decimal_r y)
 // ----------------------------------------------------------------------------
 //   Division of two decimal numbers
@@ -1818,6 +1994,9 @@ decimal_p decimal::div(decimal_r x, decimal_r y)
 //          R = R * 1000 + X[i]
 //          Q[i] = R[0] / D[0]
 //          R = R - Y * Q[i]
+//
+//   This is quadratic in the size of the divisor, so long divisors are
+//   handled by newton_div instead
 {
     if (!x || !y)
         return nullptr;
@@ -1829,6 +2008,11 @@ decimal_p decimal::div(decimal_r x, decimal_r y)
         return nullptr;
     }
 
+    // Use Newton-Raphson for long divisors
+    size_t ps = (Settings.Precision() + 2) / 3 + 1;
+    if (std::min(size_t(y->kigits()), ps) >= NEWTON_DIVISION_THRESHOLD)
+        return newton_div(x, y);
+
     // Read information from both numbers
     info     xi  = x->shape();
     info     yi  = y->shape();
@@ -1859,10 +2043,8 @@ decimal_p decimal::div(decimal_r x, decimal_r y)
     kint    *qp = rp + rs;
     kint    *xp = qp + qs;
     kint    *yp = xp + xs;
-    for (size_t xi = 0; xi < xs; xi++)
-        xp[xi] = kigit(+xb, xi);
-    for (size_t yi = 0; yi < ys; yi++)
-        yp[yi] = kigit(+yb, yi);
+    unpack(xp, +xb, xs);
+    unpack(yp, +yb, ys);
 
     // Initialize remainder and quotient with 0
     size_t rqs = rs + qs;
@@ -1981,6 +2163,45 @@ decimal_p decimal::div(decimal_r x, decimal_r y)
 }
 
 
+decimal_p decimal::newton_div(decimal_r x, decimal_r y)
+// ----------------------------------------------------------------------------
+//   Division using a Newton-Raphson iteration for the reciprocal of y
+// ----------------------------------------------------------------------------
+//   The iteration r = r + r * (1 - y * r) doubles the number of correct
+//   digits at each step, so we start with a long division at low precision,
+//   and double the precision at each step, ending a bit above the target.
+//   The cost is then a small multiple of a multiplication at full precision
+{
+    uint      digits = (Settings.Precision() + 2) / 3 * 3;
+    decimal_g one    = make(1);
+    decimal_g r, e;
+
+    precision_adjust prec(6);
+    uint  steps[16];
+    uint  nsteps = 0;
+    for (uint p = Settings.Precision();
+         p >= 3 * NEWTON_DIVISION_THRESHOLD && nsteps < 16;
+         p = (p / 2 + 5) / 3 * 3)
+        steps[nsteps++] = p;
+
+    // Initial approximation with long division
+    Settings.Precision((steps[nsteps - 1] / 2 + 5) / 3 * 3);
+    r = one / y;
+
+    // Newton-Raphson iterations
+    nursery young;
+    while (r && nsteps)
+    {
+        young.collect();
+        Settings.Precision(steps[--nsteps]);
+        e = one - y * r;
+        r = r + r * e;
+    }
+    r = x * r;
+    return r ? r->precision(digits) : nullptr;
+}
+
+
 decimal_p decimal::rem(decimal_r x, decimal_r y)
 // ----------------------------------------------------------------------------
 //   Remainder
@@ -2092,6 +2313,91 @@ decimal_p decimal::Max(decimal_r x, decimal_r y)
 //
 // ============================================================================
 
+static decimal_p integer_power(decimal_r x, ularge n)
+// ----------------------------------------------------------------------------
+//   Compute x^n by repeated squaring
+// ----------------------------------------------------------------------------
+{
+    decimal_g result = decimal::make(1);
+    decimal_g power  = x;
+    while (n && result && power)
+    {
+        if (n & 1)
+            result = result * power;
+        n >>= 1;
+        if (n)
+            power = power * power;
+    }
+    return power ? +result : nullptr;
+}
+
+
+decimal_p decimal::nth_root(decimal_r x, ularge n)
+// ----------------------------------------------------------------------------
+//   Compute the n-th root with a Newton iteration doubling precision
+// ----------------------------------------------------------------------------
+//   We iterate on s = x^(-1/n), which does not require a division:
+//     s = s + s * (1 - x * s^n) / n
+//   The initial value is computed with hardware floating-point from the
+//   leading kigits of x, and each step doubles the number of correct digits,
+//   so that only the last iteration runs at full precision.
+//   The result is then x^(1/n) = x * s^(n-1)
+{
+    if (!x)
+        return nullptr;
+    if (x->is_zero() || n == 1)
+        return x;
+
+    precision_adjust prec(6);
+    uint  steps[16];
+    uint  nsteps = 0;
+    steps[nsteps++] = Settings.Precision();
+    for (uint p = (steps[0] / 2 + 5) / 3 * 3; p >= 24 && nsteps < 16;
+         p = (p / 2 + 5) / 3 * 3)
+        steps[nsteps++] = p;
+
+    // Initial approximation from leading kigits, x = m * 10^(q*n + r)
+    info   xs = x->shape();
+    double m  = 0.0;
+    double d  = 1.0;
+    for (size_t i = 0; i < 6 && i < xs.nkigits; i++)
+    {
+        d *= 1000.0;
+        m += kigit(xs.base, i) / d;
+    }
+    large  nl = large(n);
+    large  e  = xs.exponent;
+    large  q  = e >= 0 ? e / nl : -((nl - 1 - e) / nl);
+    large  r  = e - q * nl;
+    double ls = -(std::log10(m) + double(r)) / double(n);
+    decimal_g s   = from(std::pow(10.0, ls));
+    decimal_g one = make(1);
+    decimal_g nd  = make(n);
+    decimal_g t;
+    if (s)
+        s = s * decimal_g(make(1, -q));
+
+    // Newton iterations
+    nursery young;
+    while (s && nsteps)
+    {
+        young.collect();
+        Settings.Precision(steps[--nsteps]);
+        t = integer_power(s, n);
+        t = x * t;
+        t = one - t;
+        t = t / nd;
+        t = s * t;
+        s = s + t;
+    }
+    if (!s)
+        return nullptr;
+    t = integer_power(s, n - 1);
+    t = x * t;
+    return prec(t);
+}
+
+
 decimal_p decimal::sqrt(decimal_r x)
 // ----------------------------------------------------------------------------
 //   Square root using Newton's method
@@ -2102,24 +2408,7 @@ decimal_p decimal::sqrt(decimal_r x)
         rt.domain_error();
         return nullptr;
     }
-
-    large     exponent = x->exponent();
-    decimal_g half     = make(5, -1);
-    decimal_g next     = make(5, (-exponent - 1) / 2);
-    decimal_g current  = x * next;
-    if (current && !current->is_zero())
-    {
-        precision_adjust prec(3);
-        for (uint i = 0; i < 2 * prec; i++)
-        {
-            next = (current + x / current) * half;
-            if (!next || compare(next, current, prec) == 0)
-                break;
-            current = next;
-        }
-        current = prec(current);
-    }
-    return current;
+    return nth_root(x, 2);
 }
 
 
@@ -2128,23 +2417,12 @@ decimal_p decimal::cbrt(decimal_r x)
 //  Cube root
 // ----------------------------------------------------------------------------
 {
-    large     exponent = x->exponent();
-    decimal_g third    = inv(make(3));
-    decimal_g next     = make(1, -2 * exponent / 3);
-    decimal_g current  = x * next;
-    if (current && !current->is_zero())
+    if (x->is_negative())
     {
-        precision_adjust prec(3);
-        for (uint i = 0; i < 2 * prec; i++)
-        {
-            next = ((current + current) + x / (current * current)) * third;
-            if (!next || compare(next, current, prec) == 0)
-                break;
-            current = next;
-        }
-        current = prec(current);
+        decimal_g r = nth_root(-x, 3);
+        return -r;
     }
-    return current;
+    return nth_root(x, 3);
 }
 
 
@@ -2174,6 +2452,26 @@ decimal_p decimal::cos(decimal_r x)
 }
 
 
+static void sin_ratio(uint k, large &p, large &q)
+// ----------------------------------------------------------------------------
+//   Ratio between terms of the sine series, x^(2k+1) / (2k+1)!
+// ----------------------------------------------------------------------------
+{
+    p = 1;
+    q = large(2 * k) * large(2 * k + 1);
+}
+
+
+static void cos_ratio(uint k, large &p, large &q)
+// ----------------------------------------------------------------------------
+//   Ratio between terms of the cosine series, x^(2k) / (2k)!
+// ----------------------------------------------------------------------------
+{
+    p = 1;
+    q = large(2 * k - 1) * large(2 * k);
+}
+
+
 decimal_p decimal::sin_fracpi(uint qturns, decimal_r fp)
 // ----------------------------------------------------------------------------
 //   Compute the sine of input expressed as fraction of pi
@@ -2198,44 +2496,21 @@ decimal_p decimal::sin_fracpi(uint qturns, decimal_r fp)
         return cos_fracpi((qturns - 1U) % 4, fp);
 
     // Scale by pi / 2, sum is between 0 and pi/4
+    precision_adjust prec(6);
     decimal_g sum = fp;
     decimal_g fact = make(2);
-    decimal_g tmp;
     sum = sum / fact;
-    sum = sum * pi();
-    fact = make(6); // 3!
-
-    // Prepare power factor and square that we multiply by every time
-    decimal_g power = sum;
-    decimal_g square = sum * sum;
-
-    uint prec = Settings.Precision();
-    for (uint i = 3; i < prec; i += 2)
-    {
-        power = power * square; // First iteration is x^3
-        tmp = power / fact;     // x^3 / 3!
-
-        // Check if we ran out of memory
-        if (!sum || !tmp)
-            return nullptr;
+    sum = sum * decimal_g(mpconstants().current_pi());
 
-        // If what we add no longer has an impact, we can exit
-        if (tmp->exponent() + large(prec) < sum->exponent())
-            break;
-
-        if ((i / 2) & 1)
-            sum = sum - tmp;
-        else
-            sum = sum + tmp;
-
-        tmp = make((i+1) * (i+2)); // First iteration: 4 * 5
-        fact = fact * tmp;
-    }
+    // sin(x) = x * sum((-x^2)^k / (2k+1)!)
+    decimal_g square = -(sum * sum);
+    decimal_g tmp = series(square, sin_ratio);
+    sum = sum * tmp;
 
     // sin(x+pi) = -si(x)
     if (qturns != 0)
         sum = -sum;
-    return sum;
+    return prec(sum);
 }
 
 
@@ -2261,46 +2536,20 @@ decimal_p decimal::cos_fracpi(uint qturns, decimal_r fp)
         return sin_fracpi((qturns - 3U) % 4, fp);
 
     // Scale by pi / 2, sum is between 0 and pi/4
+    precision_adjust prec(6);
     decimal_g sum = fp;
-    decimal_g fact = make(2); // Also 2!
-    decimal_g tmp;
+    decimal_g fact = make(2);
     sum = sum / fact;
-    sum = sum * pi();
-
-    // Prepare power factor and square that we multiply by every time
-    decimal_g square = sum * sum;
-    decimal_g power = square;
-
-    // For cosine, the sum starts at 1
-    sum = make(1);
+    sum = sum * decimal_g(mpconstants().current_pi());
 
-    uint prec = Settings.Precision();
-    for (uint i = 2; i < prec; i += 2)
-    {
-        tmp = power / fact;     // x^2 / 2!
-
-        // Check if we ran out of memory
-        if (!sum || !tmp)
-            return nullptr;
-
-        // If what we add no longer has an impact, we can exit
-        if (tmp->exponent() + large(prec) < sum->exponent())
-            break;
-
-        if ((i / 2) & 1)
-            sum = sum - tmp;
-        else
-            sum = sum + tmp;
-
-        power = power * square; // Next iteration is x^4
-        tmp = make((i+1) * (i+2)); // First iteration: 4 * 5
-        fact = fact * tmp;
-    }
+    // cos(x) = sum((-x^2)^k / (2k)!)
+    decimal_g square = -(sum * sum);
+    sum = series(square, cos_ratio);
 
     // sin(x+pi) = -si(x)
     if (qturns != 0)
         sum = -sum;
-    return sum;
+    return prec(sum);
 }
 
 
@@ -2368,6 +2617,16 @@ decimal_p decimal::acos(decimal_r x)
 }
 
 
+static void atanh_ratio(uint k, large &p, large &q)
+// ----------------------------------------------------------------------------
+//   Ratio between terms of the atan and atanh series, x^(2k+1) / (2k+1)
+// ----------------------------------------------------------------------------
+{
+    p = 2 * k - 1;
+    q = 2 * k + 1;
+}
+
+
 decimal_p decimal::atan(decimal_r x)
 // ----------------------------------------------------------------------------
 //  Implementation of arctan
@@ -2415,39 +2674,34 @@ decimal_p decimal::atan(decimal_r x)
         return i;
     }
 
-    // Prepare power factor and square that we multiply by every time
-    decimal_g tmp;
+    // Halve the angle to speed up convergence of the series:
+    // atan(x) = 2 * atan(x / (1 + sqrt(1 + x^2)))
+    decimal_g one = make(1);
     decimal_g sum = x;
-    decimal_g square = x * x;
-    decimal_g power = x;
-
+    decimal_g tmp;
+    uint      halvings = 0;
     record(decimal, "atan of %t", +x);
-    record(decimal, "sum=   %t", +sum);
-    record(decimal, "power= %t", +power);
-    record(decimal, "square=%t", +square);
-
-    uint prec = Settings.Precision();
-    for (uint i = 3; i < 3 * prec; i += 2)
-    {
-        power = power * square;
-        record(decimal, "%u: power= %t", i, +power);
-        tmp = make(i);
-        tmp = power / tmp;     // x^2 / 2
-        record(decimal, "%u: factor=%t exponent %lld", i, +tmp, tmp->exponent());
-        // Check if we ran out of memory
-        if (!sum || !tmp)
+    while (sum->exponent() >= 0)
+    {
+        tmp = sum * sum + one;
+        tmp = sqrt(tmp);
+        tmp = tmp + one;
+        sum = sum / tmp;
+        if (!sum)
             return nullptr;
+        halvings++;
+    }
 
-        // If what we add no longer has an impact, we can exit
-        if (tmp->exponent() + large(prec) < sum->exponent())
-            break;
-
-        if ((i/2) & 1)
-            sum = sum - tmp;
-        else
-            sum = sum + tmp;
-        record(decimal, "%u: sum=   %t exponent %lld", i, +sum, sum->exponent());
+    // atan(x) = x * sum((-x^2)^k / (2k+1))
+    tmp = -(sum * sum);
+    tmp = series(tmp, atanh_ratio);
+    sum = sum * tmp;
+    if (halvings)
+    {
+        tmp = make(1 << halvings);
+        sum = sum * tmp;
     }
+    record(decimal, "atan is %t after %u halvings", +sum, halvings);
 
     // Convert to current angle mode
     sum = sum->adjust_to_angle();
@@ -2544,6 +2798,7 @@ decimal_p decimal::log1p(decimal_r x)
         return nullptr;
     }
 
+    precision_adjust prec(9);
     large     texp  = x->exponent();
     large     eexp  = texp * 3 / 2;
     large     ipart = 0;
@@ -2553,7 +2808,7 @@ decimal_p decimal::log1p(decimal_r x)
     record(decimal, "Start with %t exp=%ld eexp=%ld", +scaled, texp, eexp);
     while (eexp > 0)
     {
-        power = constants().e;
+        power = mpconstants().current_e();
         scale = one;
         ipart += eexp;
 
@@ -2580,7 +2835,7 @@ decimal_p decimal::log1p(decimal_r x)
         record(decimal, "Rescaling, %t, exp=%ld eexp=%ld ipart=%ld",
                +scaled, texp, eexp, ipart);
 
-        scale = constants().e;
+        scale = mpconstants().current_e();
         if (scaled->is_negative())
         {
             scaled = (one + scaled) * scale - one;
@@ -2596,40 +2851,31 @@ decimal_p decimal::log1p(decimal_r x)
     record(decimal, "Taylor series with %t exp=%ld eexp=%ld ipart=%ld",
            +scaled, texp, eexp, ipart);
 
-    // Taylor's serie
-    decimal_g sum = scaled;
-    uint prec = Settings.Precision();
-    power = scaled;
-    for (uint i = 2; i < 3*prec; i++)
-    {
-        power = power * scaled;
-        scale = make(i);
-        scale = power / scale;
-
-        if (!sum || !scale)
-            return nullptr;
-
-        // If what we add no longer has an impact, we can exit
-        if (scale->exponent() + large(prec) < sum->exponent())
-        {
-            record(decimal, "Taylor exits at %u exp=%ld", i, scale->exponent());
-            break;
-        }
-
-        if (i & 1)
-            sum = sum + scale;
-        else
-            sum = sum - scale;
-    }
-    record(decimal, "Power at exit %t exponent %ld", +power, power->exponent());
-    record(decimal, "Sum   at exit %t exponent %ld", +sum, sum->exponent());
+    // ln(1+x) = 2 * atanh(x / (2 + x)), which converges faster
+    decimal_g sum = scaled + one + one;
+    sum = scaled / sum;
+    power = sum * sum;
+    power = series(power, atanh_ratio);
+    sum = sum * power;
+    sum = sum + sum;
+    record(decimal, "Sum   at exit %t exponent %ld", +sum, sum ? sum->exponent() : 0);
 
     if (ipart)
     {
         scale = make(ipart);
         sum = sum + scale;
     }
-    return sum;
+    return prec(sum);
+}
+
+
+static void expm1_ratio(uint k, large &p, large &q)
+// ----------------------------------------------------------------------------
+//   Ratio between terms of the expm1 series, x^(k+1) / (k+1)!
+// ----------------------------------------------------------------------------
+{
+    p = 1;
+    q = k + 1;
 }
 
 
@@ -2646,40 +2892,19 @@ decimal_p decimal::expm1(decimal_r x)
     if (!x->split(ip, fp))
         return nullptr;
 
-    // Prepare power factor and square that we multiply by every time
-    decimal_g one =  make(1);
-    decimal_g sum = fp;
-    decimal_g fact = one;
-    decimal_g power = fp;
-    decimal_g tmp;
-
-    uint prec = Settings.Precision();
-    for (uint i = 2; i < prec; i++)
-    {
-        power = power * fp;
-        tmp = make(i);
-        fact = fact * tmp;
-
-        tmp = power / fact;     // x^2 / 2!
-
-        // Check if we ran out of memory
-        if (!sum || !tmp)
-            return nullptr;
-
-        // If what we add no longer has an impact, we can exit
-        if (tmp->exponent() + large(prec) < sum->exponent())
-            break;
-
-        sum = sum + tmp;
-    }
+    // exp(x) - 1 = x * sum(x^k / (k+1)!)
+    precision_adjust prec(9);
+    decimal_g one = make(1);
+    decimal_g sum = series(fp, expm1_ratio);
+    sum = sum * fp;
 
     if (ip)
     {
         bool neg = ip < 0;
         if (neg)
             ip = -ip;
-        fact = one;
-        power = constants().e;
+        decimal_g fact = one;
+        decimal_g power = mpconstants().current_e();
         while (ip)
         {
             if (ip & 1)
@@ -2694,7 +2919,7 @@ decimal_p decimal::expm1(decimal_r x)
             sum = (sum + one) * fact - one;
     }
 
-    return sum;
+    return prec(sum);
 }
 
 
@@ -2775,6 +3000,7 @@ decimal_p decimal::exp(decimal_r x)
         return nullptr;
 
     // Compute exponential for integral part
+    precision_adjust prec(9);
     decimal_g one = make(1);
     decimal_g result = expm1(fp);
     result = (one + result);
@@ -2785,7 +3011,7 @@ decimal_p decimal::exp(decimal_r x)
         if (neg)
             ip = - ip;
         decimal_g scale = one;
-        decimal_g power = constants().e;
+        decimal_g power = mpconstants().current_e();
         while (ip)
         {
             if (ip & 1)
@@ -2800,7 +3026,7 @@ decimal_p decimal::exp(decimal_r x)
             result = result * scale;
     }
 
-    return result;
+    return prec(result);
 }
 
 
@@ -2864,8 +3090,10 @@ decimal_p decimal::erf(decimal_r x)
     decimal_g tmp;
 
     uint prec = Settings.Precision();
+    nursery young;
     for (uint i = 1; i < 2 * prec; i++)
     {
+        young.collect();
         // First term is x^3 / (3 * 1!), second is x^5 / (5 * 2!)
         power = power * square;         // x^3
         tmp = make(i);                  // 1
@@ -2920,8 +3148,10 @@ decimal_p decimal::erfc(decimal_r x)
     square = square + square;           // 2x^2
 
     uint prec = Settings.Precision();
+    nursery young;
     for (uint i = 1; i < prec; i++)
     {
+        young.collect();
         // First term is x^3 / (3 * 1!), second is x^5 / (5 * 2!)
         power = power * square;         // (2x^3)^1
         tmp = make(2*i-1);              // 1, 3, 5, ...
@@ -2983,15 +3213,14 @@ decimal_p decimal::tgamma(decimal_r x)
         ip = sin_fracpi(0, ip);
         fp = make(1);
         fp = fp - x;
-        fp = lgamma_internal(fp);
-        fp = exp(fp);
+        fp = spouge(fp, false);
         fp = fp * ip;
         ip = constants().pi;
         fp = ip / fp;
     }
     else
     {
-        fp = exp(lgamma_internal(x));
+        fp = spouge(x, false);
     }
     fp = prec(fp);
     return fp;
@@ -3056,6 +3285,19 @@ decimal_p decimal::lgamma_internal(decimal_r x)
         return fp;
     }
 
+    return spouge(x, true);
+}
+
+
+decimal_p decimal::spouge(decimal_r x, bool logarithm)
+// ----------------------------------------------------------------------------
+//   Spouge's approximation of gamma or its logarithm for positive x
+// ----------------------------------------------------------------------------
+//   The coefficients, including sqrt(2*pi), only depend on the precision.
+//   They are memoized in the constants cache, and computed on first use,
+//   so that repeated evaluations only cost the sum and a few logarithms.
+//   When computing gamma itself, we avoid two of these logarithms.
+{
     // Spouge's approximation uses a factor `a` - Compute it here
     uint digits = Settings.Precision();
     decimal_g tmp = make(digits + 4);
@@ -3067,20 +3309,34 @@ decimal_p decimal::lgamma_internal(decimal_r x)
     uint na = a->as_unsigned();
     record(decimal, "a=%t na=%u", +a, na);
     decimal_g *cks = constants().gamma_realloc(na);
+    if (!cks)
+    {
+        rt.out_of_memory_error();
+        return nullptr;
+    }
+
+    // First coefficient is sqrt(2*pi), computed at the working precision
+    if (!cks[0])
+    {
+        tmp = constants().pi;
+        cks[0] = sqrt(tmp + tmp);
+    }
 
     // Loop for terms except first one
     decimal_g factorial = make(1);
-    decimal_g sum       = constants().sqrt_2pi();
+    decimal_g sum       = cks[0];
     decimal_g one       = make(1);
     decimal_g z         = x;
     decimal_g ck, power, scale;
     record(decimal, "First sum %t", +sum);
+    nursery young;
     for (uint i = 1; i < na; i++)
     {
+        young.collect();
         z   = z + one;
         record(decimal, "%u: z=%t", i, +z);
 
-        tmp = cks[i-1];
+        tmp = cks[i];
         if (!tmp)
         {
             uint t  = na - i;
@@ -3101,7 +3357,7 @@ decimal_p decimal::lgamma_internal(decimal_r x)
             record(decimal, "%u: sqrt=%t", i, +tmp);
             tmp = tmp * scale / factorial;
 
-            cks[i-1] = tmp;
+            cks[i] = tmp;
             if (!tmp)
                 return nullptr;
 
@@ -3117,15 +3373,24 @@ decimal_p decimal::lgamma_internal(decimal_r x)
         record(decimal, "%u: sum=%t", i, +sum);
     }
 
-    sum = log(sum);
-
-    // Add first term
+    // Add first term, (x+a)^(x+1/2) * exp(-(x+a)) / x
     tmp = x + a;
     z = make(5, -1);
     z = x + z;
-    a = log(x);
-    tmp = log(tmp) * z - tmp - a;
-    sum = sum + tmp;
+    if (logarithm)
+    {
+        sum = log(sum);
+        a = log(x);
+        tmp = log(tmp) * z - tmp - a;
+        sum = sum + tmp;
+    }
+    else
+    {
+        tmp = log(tmp) * z - tmp;
+        tmp = exp(tmp);
+        sum = sum * tmp;
+        sum = sum / x;
+    }
 
     return sum;
 }
@@ -3265,11 +3530,26 @@ decimal_p decimal::xroot(decimal_r y, decimal_r x)
         }
     }
 
+    // Integer roots use Newton's method
+    if (is_int && iip)
+    {
+        ularge n = iip < 0 ? -iip : iip;
+        if (is_neg)
+        {
+            xfp = nth_root(-y, n);
+            xfp = -xfp;
+        }
+        else
+        {
+            xfp = nth_root(y, n);
+        }
+        if (iip < 0)
+            xfp = inv(xfp);
+        return xfp;
+    }
+
     xfp = inv(x);
-    if (is_neg)
-        xfp = neg(pow(neg(y), xfp));
-    else
-        xfp = pow(y, xfp);
+    xfp = pow(y, xfp);
     return xfp;
 }
 
@@ -3291,8 +3571,10 @@ decimal_p decimal::fact(decimal_r x)
     }
 
     decimal_g r = make(1);
+    nursery young;
     for (large i = 2; i <= ip; i++)
     {
+        young.collect();
         fp = make(i);
         r = r * fp;
     }
@@ -3307,12 +3589,268 @@ decimal_p decimal::fact(decimal_r x)
 //
 // ============================================================================
 
+decimal_p decimal::series(decimal_r y, series_ratio ratio)
+// ----------------------------------------------------------------------------
+//   Sum a series where the ratio between terms is y times a small rational
+// ----------------------------------------------------------------------------
+//   The series is evaluated backwards with Horner's scheme, in blocks of
+//   m terms where the product of the m ratios stays below 10^15:
+//
+//     S[k] = t[k] + t[k+1] + ... = 1 + y*r[k+1] * (1 + y*r[k+2] * (...))
+//     Q * S[k] = C[0] + C[1]*y + ... + C[m-1]*y^(m-1) + C[m]*y^m*S[k+m]
+//
+//   where Q = C[0] = q[k+1]...q[k+m] and C[i] = p[k+1]...p[k+i] *
+//   q[k+i+1]...q[k+m]. Powers of y are computed once, so each block only
+//   costs one full-size multiplication and a division by a short Q, the
+//   other operations being multiplications by short integers.
+//   Each block rounds once, so the sum is computed with guard digits.
+{
+    if (!y)
+        return nullptr;
+    if (y->is_zero())
+        return make(1);
+
+    // Estimate the number of terms from the magnitude of y and the ratios
+    const uint       MAX_BLOCK = 8;
+    precision_adjust prec(6);
+    uint             digits = Settings.Precision();
+    double     ly = y->exponent() + std::log10((y->kigit(0) + 1) / 1000.0);
+    double     lt = 0.0;
+    uint       n  = 1;
+    for (; n < 10 * digits + 100; n++)
+    {
+        large p, q;
+        ratio(n, p, q);
+        lt += ly + std::log10(std::fabs(double(p)) / double(q));
+        if (lt < -double(digits) - 3)
+            break;
+    }
+
+    // Compute the powers of y we need
+    uint       maxm = 1;
+    while (maxm < MAX_BLOCK && maxm * maxm < n)
+        maxm++;
+    decimal_g  powers[MAX_BLOCK + 1];
+    powers[1] = y;
+    for (uint i = 2; i <= maxm; i++)
+        powers[i] = powers[i-1] * y;
+
+    // Evaluate blocks from the last one
+    decimal_g  sum, acc, tmp;
+    uint       end = n;
+    nursery    young;
+    while (end > 0)
+    {
+        // Find how many ratios we can multiply together below 10^15,
+        // so that the integer constructor of decimal does not overflow
+        large  p[MAX_BLOCK], q[MAX_BLOCK];
+        ularge bound = 1;
+        uint   m     = 0;
+        while (m < maxm && m < end)
+        {
+            large  pk, qk;
+            ratio(end - m, pk, qk);
+            ularge mag = std::max(ularge(pk < 0 ? -pk : pk), ularge(qk));
+            if (m && bound > 1000000000000000ULL / mag)
+                break;
+            bound *= mag;
+            p[m] = pk;
+            q[m] = qk;
+            m++;
+        }
+        std::reverse(p, p + m);
+        std::reverse(q, q + m);
+
+        // Build the block, with C[i] computed from products of p and q
+        young.collect();
+        large c = 1;
+        for (uint j = 0; j < m; j++)
+            c *= q[j];
+        large div = c;
+        acc = make(c);
+        for (uint i = 1; i <= m; i++)
+        {
+            c = c / q[i-1] * p[i-1];
+            if (i < m)
+                tmp = powers[i];
+            else if (sum)
+                tmp = powers[m] * sum;
+            else
+                break;
+            tmp = tmp * make(c);
+            acc = acc + tmp;
+        }
+        sum = acc / make(div);
+        if (!sum)
+            return nullptr;
+        end -= m;
+    }
+    return prec(sum);
+}
+
+
 #include "decimal-pi.h"
 #include "decimal-e.h"
 
-decimal::ccache &decimal::constants()
+static void chudnovsky(uint a, uint b,
+                       decimal_g &p, decimal_g &q, decimal_g &t)
 // ----------------------------------------------------------------------------
-//   Initialize the constants used for adjustments
+//   Binary splitting of the Chudnovsky series between terms a and b
+// ----------------------------------------------------------------------------
+//   For a single term k, p = (6k-5)(2k-1)(6k-1), q = k^3 * 640320^3 / 24
+//   and t = (-1)^k * p * (13591409 + 545140134 k). Ranges are combined with
+//   p = p1*p2, q = q1*q2 and t = t1*q2 + p1*t2.
+{
+    if (b - a == 1)
+    {
+        if (a == 0)
+        {
+            p = decimal::make(1);
+            q = p;
+        }
+        else
+        {
+            p = decimal::make(large(6*a-5) * large(2*a-1) * large(6*a-1));
+            q = decimal::make(large(a) * large(a) * large(a));
+            t = decimal::make(10939058860032LL, 3);
+            q = q * t;
+        }
+        t = decimal::make(13591409LL + 545140134LL * a);
+        t = p * t;
+        if (a & 1)
+            t = -t;
+        return;
+    }
+
+    uint      m = (a + b) / 2;
+    decimal_g p2, q2, t2;
+    chudnovsky(a, m, p, q, t);
+    chudnovsky(m, b, p2, q2, t2);
+    t = t * q2;
+    t2 = p * t2;
+    t = t + t2;
+    p = p * p2;
+    q = q * q2;
+}
+
+
+static decimal_p compute_pi()
+// ----------------------------------------------------------------------------
+//   Compute pi at current precision using the Chudnovsky formula
+// ----------------------------------------------------------------------------
+//   pi = 426880 * sqrt(10005) * Q / T, each term adding ~14.18 digits
+{
+    decimal::precision_adjust prec(9);
+    uint      terms = Settings.Precision() * 100 / 1418 + 2;
+    decimal_g p, q, t;
+    chudnovsky(0, terms, p, q, t);
+    if (!t)
+        return nullptr;
+    decimal_g r = decimal::make(10005);
+    r = decimal::sqrt(r);
+    p = decimal::make(426880);
+    r = r * p;
+    r = r * q;
+    r = r / t;
+    return r;
+}
+
+
+static decimal_p compute_e()
+// ----------------------------------------------------------------------------
+//   Compute e at current precision as 1 + sum(1/(k+1)!)
+// ----------------------------------------------------------------------------
+{
+    decimal::precision_adjust prec(6);
+    decimal_g one = decimal::make(1);
+    decimal_g sum = decimal::series(one, expm1_ratio);
+    return sum + one;
+}
+
+
+static decimal_p atanh_inverse(uint n)
+// ----------------------------------------------------------------------------
+//   Compute atanh(1/n) with the atanh series
+// ----------------------------------------------------------------------------
+{
+    decimal_g x = decimal::make(n);
+    decimal_g one = decimal::make(1);
+    x = one / x;
+    decimal_g sq = x * x;
+    sq = decimal::series(sq, atanh_ratio);
+    return x * sq;
+}
+
+
+static decimal_p compute_ln2()
+// ----------------------------------------------------------------------------
+//   Compute ln(2) from a Machin-like atanh formula
+// ----------------------------------------------------------------------------
+//   ln(2) = 18 atanh(1/26) - 2 atanh(1/4801) + 8 atanh(1/8749)
+{
+    decimal::precision_adjust prec(6);
+    decimal_g sum = atanh_inverse(26);
+    decimal_g tmp = decimal::make(18);
+    sum = sum * tmp;
+    tmp = atanh_inverse(4801);
+    tmp = tmp + tmp;
+    sum = sum - tmp;
+    tmp = atanh_inverse(8749);
+    tmp = tmp * decimal_g(decimal::make(8));
+    return sum + tmp;
+}
+
+
+static decimal_p compute_ln10()
+// ----------------------------------------------------------------------------
+//   Compute ln(10) = 3 ln(2) + ln(5/4) = 3 ln(2) + 2 atanh(1/9)
+// ----------------------------------------------------------------------------
+{
+    decimal::precision_adjust prec(6);
+    decimal_g sum = compute_ln2();
+    decimal_g tmp = sum + sum;
+    sum = sum + tmp;
+    tmp = atanh_inverse(9);
+    tmp = tmp + tmp;
+    return sum + tmp;
+}
+
+
+decimal_p decimal::mpconstant::get(size_t nkigs, generator gen,
+                                   byte_p table, size_t tkigs)
+// ----------------------------------------------------------------------------
+//   Return a constant with nkigs kigits, computing it only when necessary
+// ----------------------------------------------------------------------------
+//   Values that fit in the table are taken from there. Otherwise, the
+//   value with the highest precision computed so far is rounded, and it
+//   is only recomputed when a higher precision is requested.
+{
+    if (nkigs < tkigs)
+    {
+        decimal_g full = rt.make<decimal>(1, nkigs + 1, gcbytes(table));
+        return full ? full->precision(3 * nkigs) : nullptr;
+    }
+    if (nkigs == tkigs)
+        return rt.make<decimal>(1, nkigs, gcbytes(table));
+
+    if (!value || kigits < nkigs)
+    {
+        record(decimal, "Computing constant with %u kigits, had %u",
+               nkigs, kigits);
+        decimal_g computed = gen();
+        if (!computed)
+            return nullptr;
+        value = computed;
+        kigits = nkigs;
+    }
+
+    return value->precision(3 * nkigs);
+}
+
+
+decimal::ccache &decimal::mpconstants()
+// ----------------------------------------------------------------------------
+//   Return the constants cache without adjusting it to current precision
 // ----------------------------------------------------------------------------
 {
     static ccache *cst = nullptr;
@@ -3322,12 +3860,21 @@ decimal::ccache &decimal::constants()
         cst = (ccache *) malloc(sizeof(ccache));
         new(cst) ccache;
     }
+    return *cst;
+}
+
+
+decimal::ccache &decimal::constants()
+// ----------------------------------------------------------------------------
+//   Initialize the constants used for adjustments
+// ----------------------------------------------------------------------------
+{
+    ccache *cst = &mpconstants();
     size_t precision = Settings.Precision();
     if (cst->precision != precision)
     {
-        size_t nkigs   = (precision + 2) / 3;
-        cst->pi        = rt.make<decimal>(1, nkigs, gcbytes(decimal_pi));
-        cst->e         = rt.make<decimal>(1, nkigs, gcbytes(decimal_e));
+        cst->pi        = cst->current_pi();
+        cst->e         = cst->current_e();
         cst->log10     = nullptr;
         cst->log2      = nullptr;
         cst->sq2pi     = nullptr;
@@ -3339,16 +3886,35 @@ decimal::ccache &decimal::constants()
 }
 
 
+static const size_t TABLE_KIGITS = 3334; // In decimal-pi.h and decimal-e.h
+
+decimal_p decimal::ccache::current_pi()
+// ----------------------------------------------------------------------------
+//   Return pi at current precision, which may differ from cache precision
+// ----------------------------------------------------------------------------
+{
+    size_t nkigs = (Settings.Precision() + 2) / 3;
+    return hpi.get(nkigs, compute_pi, decimal_pi, TABLE_KIGITS);
+}
+
+
+decimal_p decimal::ccache::current_e()
+// ----------------------------------------------------------------------------
+//   Return e at current precision, which may differ from cache precision
+// ----------------------------------------------------------------------------
+{
+    size_t nkigs = (Settings.Precision() + 2) / 3;
+    return he.get(nkigs, compute_e, decimal_e, TABLE_KIGITS);
+}
+
+
 decimal_r decimal::ccache::ln10()
 // ----------------------------------------------------------------------------
 //   Compute and cache the natural logarithm of 10
 // ----------------------------------------------------------------------------
 {
     if (!log10)
-    {
-        decimal_g ten = make(10);
-        log10 = log(ten);
-    }
+        log10 = hlog10.get((precision + 2) / 3, compute_ln10);
     return log10;
 }
 
@@ -3359,10 +3925,7 @@ decimal_r decimal::ccache::ln2()
 // ----------------------------------------------------------------------------
 {
     if (!log2)
-    {
-        decimal_g two = make(2);
-        log2 = log(two);
-    }
+        log2 = hlog2.get((precision + 2) / 3, compute_ln2);
     return log2;
 }
 
@@ -3414,6 +3977,29 @@ decimal_g decimal::ccache::two_over_sqrt_pi()
 }
 
 
+static decimal_p compute_two_over_pi()
+// ----------------------------------------------------------------------------
+//   Compute 2/pi at current precision
+// ----------------------------------------------------------------------------
+{
+    decimal::precision_adjust prec(6);
+    decimal_g two = decimal::make(2);
+    decimal_g pi  = decimal::mpconstants().current_pi();
+    return two / pi;
+}
+
+
+decimal_p decimal::ccache::two_over_pi()
+// ----------------------------------------------------------------------------
+//   Return 2/pi at current precision, which may differ from cache precision
+// ----------------------------------------------------------------------------
+//   This is used for argument reduction, where the precision depends on the
+//   magnitude of the argument, so the value is not cached for one precision
+{
+    return h2opi.get((Settings.Precision() + 2) / 3, compute_two_over_pi);
+}
+
+
 decimal_g *decimal::ccache::gamma_realloc(size_t na)
 // ----------------------------------------------------------------------------
 //    Reallocate the constants for gamma computation
@@ -3421,7 +4007,7 @@ decimal_g *decimal::ccache::gamma_realloc(size_t na)
 {
     if (na != gamma_na)
     {
-        size_t rna = gamma_na - 1;
+        size_t rna = gamma_na;
         if (gamma_ck)
         {
             // No operator new[] nor operator delete[] in embedded runtime
@@ -3430,10 +4016,10 @@ decimal_g *decimal::ccache::gamma_realloc(size_t na)
             free(gamma_ck);
             gamma_ck = nullptr;
         }
-        if (na > 1)
+        if (na)
         {
             // No operator new[] nor operator delete[] in embedded runtime
-            rna = na - 1;
+            rna = na;
             gamma_ck = (decimal_g *) calloc(rna, sizeof(decimal_g));
             if (!gamma_ck)
                 na = rna = 0;
@@ -3458,7 +4044,12 @@ bool decimal::adjust_from_angle(uint &qturns, decimal_g &fp) const
     case object::ID_Grad:      x = x * decimal_g(make(1,-2)); break;
     case object::ID_PiRadians: x = x + x; break;
     default:
-    case object::ID_Rad:       x = x / pi(); x = x + x; break;
+    case object::ID_Rad:
+        if (x->exponent() > 0 && x->exponent() <= DB48X_MAXDIGITS)
+            return reduce_radians(qturns, fp);
+        x = x / pi();
+        x = x + x;
+        break;
     }
 
     decimal_g ip;
@@ -3485,6 +4076,34 @@ bool decimal::adjust_from_angle(uint &qturns, decimal_g &fp) const
 }
 
 
+bool decimal::reduce_radians(uint &qturns, decimal_g &fp) const
+// ----------------------------------------------------------------------------
+//   Reduce a large angle in radians to quarter turns and fractional part
+// ----------------------------------------------------------------------------
+//   Like the Payne-Hanek reduction, this multiplies by 2/pi with enough
+//   digits that the fractional part keeps the working precision. 2/pi is
+//   kept in a cache which is extended as needed, so that it is only
+//   recomputed when the argument requires more digits than ever before.
+{
+    decimal_g x = this;
+    decimal_g ip;
+    {
+        precision_adjust prec(x->exponent() + 3);
+        x = x * mpconstants().two_over_pi();
+        if (!x || !x->split(ip, fp))
+            return false;
+        decimal_g turn = make(4);
+        ip = rem(ip, turn);
+        fp = prec(fp);
+        if (!ip || !fp)
+            return false;
+    }
+    large q = ip->as_integer();
+    qturns = uint(q);
+    return true;
+}
+
+
 decimal_p decimal::adjust_to_angle() const
 // ----------------------------------------------------------------------------
 //   Adjust an angle value for asin/acos/atan
@@ -114,9 +114,7 @@ struct decimal : algebraic
         byte *p = (byte *) payload(this);
         p = leb128(p, exp);
         p = leb128(p, nkigs);
-        const kint *kigsp = kigs.Safe();
-        for (uint i = 0; i < nkigs; i++)
-            kigit(p, i, kigsp[i]);
+        pack(p, kigs.Safe(), nkigs);
     }
     static size_t required_memory(id type, large exp, size_t n, gcp<kint>)
     {
@@ -286,6 +284,44 @@ struct decimal : algebraic
     }
 
 
+    static void unpack(kint *kigs, byte_p base, size_t count)
+    // ------------------------------------------------------------------------
+    //   Unpack kigits into a word-aligned array for arithmetic kernels
+    // ------------------------------------------------------------------------
+    //   Four kigits fit exactly in five bytes, so we decode them in groups
+    {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4, base += 5)
+        {
+            kigs[i+0] = (kint(base[0]) << 2)        | (base[1] >> 6);
+            kigs[i+1] = (kint(base[1] & 0x3F) << 4) | (base[2] >> 4);
+            kigs[i+2] = (kint(base[2] & 0x0F) << 6) | (base[3] >> 2);
+            kigs[i+3] = (kint(base[3] & 0x03) << 8) | base[4];
+        }
+        for (size_t g = 0; i < count; i++, g++)
+            kigs[i] = kigit(base, g);
+    }
+
+
+    static void pack(byte *base, const kint *kigs, size_t count)
+    // ------------------------------------------------------------------------
+    //   Pack kigits from a word-aligned array into the compact form
+    // ------------------------------------------------------------------------
+    {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4, base += 5)
+        {
+            base[0] = byte(kigs[i+0] >> 2);
+            base[1] = byte(kigs[i+0] << 6) | byte(kigs[i+1] >> 4);
+            base[2] = byte(kigs[i+1] << 4) | byte(kigs[i+2] >> 6);
+            base[3] = byte(kigs[i+2] << 2) | byte(kigs[i+3] >> 8);
+            base[4] = byte(kigs[i+3]);
+        }
+        for (size_t g = 0; i < count; i++, g++)
+            kigit(base, g, kigs[i]);
+    }
+
+
     kint kigit(size_t index) const
     // ------------------------------------------------------------------------
     //   Return the given kigit for the current number
@@ -486,6 +522,7 @@ struct decimal : algebraic
     static decimal_p sub(decimal_r x, decimal_r y);
     static decimal_p mul(decimal_r x, decimal_r y);
     static decimal_p div(decimal_r x, decimal_r y);
+    static decimal_p newton_div(decimal_r x, decimal_r y);
     static decimal_p mod(decimal_r x, decimal_r y);
     static decimal_p rem(decimal_r x, decimal_r y);
     static decimal_p pow(decimal_r x, decimal_r y);
@@ -536,6 +573,7 @@ struct decimal : algebraic
     static decimal_p tgamma(decimal_r x);
     static decimal_p lgamma(decimal_r x);
     static decimal_p lgamma_internal(decimal_r x);
+    static decimal_p spouge(decimal_r x, bool logarithm);
 
     static decimal_p abs(decimal_r x);
     static decimal_p sign(decimal_r x);
@@ -557,6 +595,20 @@ struct decimal : algebraic
     //
     // ========================================================================
 
+    struct mpconstant
+    // ------------------------------------------------------------------------
+    //  A constant kept at the highest precision computed so far
+    // ------------------------------------------------------------------------
+    {
+        typedef decimal_p (*generator)();
+        mpconstant(): value(), kigits(0) {}
+        decimal_p get(size_t nkigs, generator gen,
+                      byte_p table = nullptr, size_t tkigs = 0);
+
+        decimal_g value;
+        size_t    kigits;
+    };
+
     struct ccache
     // ------------------------------------------------------------------------
     //  Constants are re-created whenever precision changes
@@ -565,6 +617,11 @@ struct decimal : algebraic
         ccache(): precision(), gamma_na(0), gamma_ck(nullptr) {}
 
         size_t  precision;
+        mpconstant hpi;
+        mpconstant he;
+        mpconstant hlog10;
+        mpconstant hlog2;
+        mpconstant h2opi;
         decimal_g pi;
         decimal_g e;
         decimal_g log10;
@@ -576,17 +633,33 @@ struct decimal : algebraic
         size_t    gamma_na;
         decimal_g *gamma_ck;
 
+        decimal_p current_pi();
+        decimal_p current_e();
         decimal_r ln10();
         decimal_r ln2();
         decimal_r lnpi();
         decimal_r sqrt_2pi();
         decimal_r one_over_sqrt_pi();
         decimal_g two_over_sqrt_pi();
+        decimal_p two_over_pi();
 
         decimal_g *gamma_realloc(size_t na);
     };
 
     static ccache   &constants();
+    static ccache   &mpconstants();
+
+
+    typedef void (*series_ratio)(uint k, large &p, large &q);
+    static decimal_p series(decimal_r y, series_ratio ratio);
+    // ------------------------------------------------------------------------
+    //   Sum of terms t[0] = 1, t[k] = t[k-1] * y * p[k] / q[k]
+    // ------------------------------------------------------------------------
+
+    static decimal_p nth_root(decimal_r x, ularge n);
+    // ------------------------------------------------------------------------
+    //   n-th root of a positive x using Newton's method
+    // ------------------------------------------------------------------------
 
 
     static decimal_p pi()       { return constants().pi; }
@@ -595,6 +668,7 @@ struct decimal : algebraic
     static decimal_p ln2()      { return constants().ln2(); }
     static decimal_p lnpi()     { return constants().lnpi(); }
     bool             adjust_from_angle(uint &qturns, decimal_g &fp) const;
+    bool             reduce_radians(uint &qturns, decimal_g &fp) const;
     decimal_p        adjust_to_angle() const;
 
 public:
@@ -30,6 +30,7 @@
 #include "expression.h"
 
 #include "arithmetic.h"
+#include "constants.h"
 #include "functions.h"
 #include "grob.h"
 #include "integer.h"
@@ -39,6 +40,7 @@
 #include "settings.h"
 #include "unit.h"
 #include "utf8.h"
+#include "variables.h"
 
 
 RECORDER(equation,      16, "Processing of equations and algebraic objects");
@@ -2587,3 +2589,400 @@ FUNCTION_BODY(Simplify)
 {
     return do_rewrite(x, &expression::simplify);
 }
+
+
+
+// ============================================================================
+//
+//   Compiled expressions for numerical evaluation
+//
+// ============================================================================
+
+compiled_expression::compiled_expression(program_r eq)
+// ----------------------------------------------------------------------------
+//   Compile the expression if possible
+// ----------------------------------------------------------------------------
+    : eq(eq), values(), operands(), relative(0), dvalues(), doperands(),
+      code(), ncode(0), ntemps(0), result(0), globals(0),
+      compiled(false), hardware(false)
+{
+    compiled = compile();
+}
+
+
+bool compiled_expression::compile()
+// ----------------------------------------------------------------------------
+//   Build the register code for an expression, return false if we can't
+// ----------------------------------------------------------------------------
+//   Every GC-safe pointer slows down memory moves, which are frequent in
+//   numerical code. So numbers in the expression are referenced by offset,
+//   values of global variables by address, since they only move when the
+//   globals generation changes, and intermediate results live on the stack.
+//   Only computed numerical constants need a GC-safe pointer.
+{
+    ncode = 0;
+    ntemps = 0;
+    relative = 0;
+    hardware = true;
+    globals = rt.globals_generation();
+    if (!eq || eq->type() != object::ID_expression || !expression::independent)
+        return false;
+
+    byte stack[MAX_DEPTH];
+    uint depth    = 0;
+    uint nvalues  = 0;
+    uint noperands = 0;
+
+    for (object_p obj : *eq)
+    {
+        object::id    ty     = obj->type();
+        object_p      value  = nullptr;
+        algebraic_fn  unary  = nullptr;
+        arithmetic_fn binary = nullptr;
+
+        switch(ty)
+        {
+        case object::ID_symbol:
+            if (symbol_p(obj)->is_same_as(*expression::independent))
+            {
+                if (depth >= MAX_DEPTH)
+                    return false;
+                stack[depth++] = X;
+                continue;
+            }
+            if (expression::dependent &&
+                symbol_p(obj)->is_same_as(*expression::dependent))
+                return false;
+            value = directory::recall_all(obj, false);
+            if (!value || !rt.is_global(value))
+                return false;
+            break;
+
+        case object::ID_constant:
+        {
+            if (!Settings.NumericalConstants() && !Settings.NumericalResults())
+                return false;
+            if (depth >= MAX_DEPTH || nvalues >= MAX_VALUES)
+                return false;
+            algebraic_p cst = constant_p(obj)->value();
+            if (!cst || (!cst->is_real() && !cst->is_complex()))
+                return false;
+            values[nvalues] = cst;
+            if (!algebraic::to_double(cst, dvalues[nvalues]))
+                hardware = false;
+            stack[depth++] = VALUES + nvalues++;
+            continue;
+        }
+
+#define COMPILE_BINARY(op)      case object::ID_##op: binary = op::evaluate; break
+        COMPILE_BINARY(add);
+        COMPILE_BINARY(sub);
+        COMPILE_BINARY(mul);
+        COMPILE_BINARY(div);
+        COMPILE_BINARY(pow);
+#undef COMPILE_BINARY
+
+#define COMPILE_UNARY(op)       case object::ID_##op: unary = op::evaluate; break
+        COMPILE_UNARY(neg);
+        COMPILE_UNARY(inv);
+        COMPILE_UNARY(sq);
+        COMPILE_UNARY(cubed);
+        COMPILE_UNARY(abs);
+        COMPILE_UNARY(sqrt);
+        COMPILE_UNARY(cbrt);
+        COMPILE_UNARY(sin);
+        COMPILE_UNARY(cos);
+        COMPILE_UNARY(tan);
+        COMPILE_UNARY(asin);
+        COMPILE_UNARY(acos);
+        COMPILE_UNARY(atan);
+        COMPILE_UNARY(sinh);
+        COMPILE_UNARY(cosh);
+        COMPILE_UNARY(tanh);
+        COMPILE_UNARY(asinh);
+        COMPILE_UNARY(acosh);
+        COMPILE_UNARY(atanh);
+        COMPILE_UNARY(log1p);
+        COMPILE_UNARY(expm1);
+        COMPILE_UNARY(log);
+        COMPILE_UNARY(log10);
+        COMPILE_UNARY(log2);
+        COMPILE_UNARY(exp);
+        COMPILE_UNARY(exp10);
+        COMPILE_UNARY(exp2);
+        COMPILE_UNARY(erf);
+        COMPILE_UNARY(erfc);
+        COMPILE_UNARY(tgamma);
+        COMPILE_UNARY(lgamma);
+#undef COMPILE_UNARY
+
+        default:
+            // Numbers in the expression are recorded as an offset
+            value = obj;
+            break;
+        }
+
+        if (unary || binary)
+        {
+            uint args = binary ? 2 : 1;
+            if (depth < args || ncode >= MAX_CODE)
+                return false;
+            depth -= args;
+            instruction &i = code[ncode++];
+            i.unary  = unary;
+            i.binary = binary;
+            i.op     = ty;
+            i.dst    = TEMPS + depth;
+            i.x      = stack[depth];
+            i.y      = binary ? stack[depth + 1] : byte(X);
+            stack[depth++] = i.dst;
+            if (ntemps < depth)
+                ntemps = depth;
+            continue;
+        }
+
+        // Only numerical values evaluate as themselves
+        object::id vty = value->type();
+        if (!object::is_real(vty) && !object::is_complex(vty))
+            return false;
+        if (depth >= MAX_DEPTH || noperands >= MAX_OPERANDS)
+            return false;
+        if (!algebraic::to_double(value, doperands[noperands]))
+            hardware = false;
+        if (value == obj)
+        {
+            relative |= 1U << noperands;
+            value = object_p(byte_p(obj) - byte_p(+eq));
+        }
+        operands[noperands] = value;
+        stack[depth++] = OPERANDS + noperands++;
+    }
+
+    if (depth != 1)
+        return false;
+    result = stack[0];
+    record(equation, "Compiled %t into %u instructions, %u temporaries",
+           +eq, ncode, ntemps);
+    return true;
+}
+
+
+algebraic_p compiled_expression::operand(byte index, algebraic_r x)
+// ----------------------------------------------------------------------------
+//   Return the value for a given operand
+// ----------------------------------------------------------------------------
+//   Temporaries are on the stack, the first one being deepest
+{
+    if (index == X)
+        return x;
+    if (index < VALUES)
+        return algebraic_p(rt.stack(ntemps - 1 - (index - TEMPS)));
+    if (index < OPERANDS)
+        return values[index - VALUES];
+    index -= OPERANDS;
+    object_p value = operands[index];
+    if (relative & (1U << index))
+        value = +eq + uintptr_t(value);
+    return algebraic_p(value);
+}
+
+
+algebraic_p compiled_expression::evaluate(algebraic_r x)
+// ----------------------------------------------------------------------------
+//   Evaluate the compiled code, or fall back to the interpreter
+// ----------------------------------------------------------------------------
+{
+    if (compiled && globals != rt.globals_generation())
+        compiled = compile();
+    if (compiled && x)
+    {
+        rt.clear_error();
+        size_t depth = rt.depth();
+        uint   t;
+        for (t = 0; t < ntemps; t++)
+            if (!rt.push(+x))
+                break;
+
+        algebraic_g  left, right;
+        instruction *last = code + ncode;
+        instruction *i    = code;
+        if (t == ntemps)
+        {
+            for (; i < last; i++)
+            {
+                left = operand(i->x, x);
+                if (i->binary)
+                {
+                    right = operand(i->y, x);
+                    left = i->binary(left, right);
+                }
+                else
+                {
+                    left = i->unary(left);
+                }
+                if (!left || !rt.stack(ntemps - 1 - (i->dst - TEMPS), left))
+                    break;
+            }
+        }
+        if (i == last && !rt.error())
+            left = operand(result, x);
+        else
+            left = nullptr;
+        if (size_t now = rt.depth() - depth)
+            rt.drop(now);
+        if (left)
+            return left;
+    }
+    return algebraic::evaluate_function(eq, x);
+}
+
+
+bool compiled_expression::hardware_op(object::id op,
+                                      double x, double y, double &r)
+// ----------------------------------------------------------------------------
+//   Evaluate one operation with hardware floating-point
+// ----------------------------------------------------------------------------
+//   Return false when the result is not finite, or when it is likely
+//   to be inaccurate, e.g. cancellation in add or sub, or trigonometric
+//   functions of very large arguments
+{
+    typedef hwfp<double> hw;
+    const double cancel = 0x1p-40; // Keep at least ~12 significant digits
+    switch(op)
+    {
+    case object::ID_add:
+    case object::ID_sub:
+        r = op == object::ID_add ? x + y : x - y;
+        if (r != 0.0 &&
+            std::fabs(r) < cancel * std::max(std::fabs(x), std::fabs(y)))
+            return false;
+        break;
+    case object::ID_mul:        r = x * y;                      break;
+    case object::ID_div:
+        if (y == 0.0)
+            return false;
+        r = x / y;
+        break;
+    case object::ID_pow:
+        if (x == 0.0 && y <= 0.0)
+            return false;
+        if (x < 0.0 && y != std::trunc(y))
+            return false;       // Complex result
+        r = std::pow(x, y);
+        break;
+    case object::ID_neg:        r = -x;                         break;
+    case object::ID_inv:
+        if (x == 0.0)
+            return false;
+        r = 1.0 / x;
+        break;
+    case object::ID_sq:         r = x * x;                      break;
+    case object::ID_cubed:      r = x * x * x;                  break;
+    case object::ID_abs:        r = std::fabs(x);               break;
+    case object::ID_sqrt:
+        if (x < 0.0)
+            return false;
+        r = std::sqrt(x);
+        break;
+    case object::ID_cbrt:       r = std::cbrt(x);               break;
+    case object::ID_sin:
+    case object::ID_cos:
+    case object::ID_tan:
+        x = hw::from_angle(x);
+        if (std::fabs(x) > 0x1p20)
+            return false;       // Argument reduction loses digits
+        r = op == object::ID_sin ? std::sin(x)
+          : op == object::ID_cos ? std::cos(x)
+          : std::tan(x);
+        break;
+    case object::ID_asin:
+    case object::ID_acos:
+        if (x < -1.0 || x > 1.0)
+            return false;
+        r = hw::to_angle(op == object::ID_asin ? std::asin(x) : std::acos(x));
+        break;
+    case object::ID_atan:       r = hw::to_angle(std::atan(x)); break;
+    case object::ID_sinh:       r = std::sinh(x);               break;
+    case object::ID_cosh:       r = std::cosh(x);               break;
+    case object::ID_tanh:       r = std::tanh(x);               break;
+    case object::ID_asinh:      r = std::asinh(x);              break;
+    case object::ID_acosh:
+        if (x < 1.0)
+            return false;
+        r = std::acosh(x);
+        break;
+    case object::ID_atanh:
+        if (x <= -1.0 || x >= 1.0)
+            return false;
+        r = std::atanh(x);
+        break;
+    case object::ID_log1p:
+        if (x <= -1.0)
+            return false;
+        r = std::log1p(x);
+        break;
+    case object::ID_expm1:      r = std::expm1(x);              break;
+    case object::ID_log:
+    case object::ID_log10:
+    case object::ID_log2:
+        if (x <= 0.0)
+            return false;
+        r = op == object::ID_log   ? std::log(x)
+          : op == object::ID_log10 ? std::log10(x)
+          : std::log2(x);
+        break;
+    case object::ID_exp:        r = std::exp(x);                break;
+    case object::ID_exp10:      r = std::pow(10.0, x);          break;
+    case object::ID_exp2:       r = std::exp2(x);               break;
+    case object::ID_erf:        r = std::erf(x);                break;
+    case object::ID_erfc:       r = std::erfc(x);               break;
+    case object::ID_tgamma:
+        if (x <= 0.0 && x == std::trunc(x))
+            return false;       // Poles
+        r = std::tgamma(x);
+        break;
+    case object::ID_lgamma:
+        if (x <= 0.0)
+            return false;
+        r = std::lgamma(x);
+        break;
+    default:
+        return false;
+    }
+    return std::isfinite(r);
+}
+
+
+bool compiled_expression::evaluate(double x, double &y)
+// ----------------------------------------------------------------------------
+//   Evaluate the compiled code with hardware doubles
+// ----------------------------------------------------------------------------
+//   Return false if the caller should evaluate with decimal instead
+{
+    if (compiled && globals != rt.globals_generation())
+        compiled = compile();
+    if (!compiled || !hardware)
+        return false;
+
+    double temps[MAX_DEPTH];
+    auto   value = [&](byte index) -> double
+    {
+        if (index == X)
+            return x;
+        if (index < VALUES)
+            return temps[index - TEMPS];
+        if (index < OPERANDS)
+            return dvalues[index - VALUES];
+        return doperands[index - OPERANDS];
+    };
+
+    for (instruction *i = code, *last = code + ncode; i < last; i++)
+    {
+        double left  = value(i->x);
+        double right = i->binary ? value(i->y) : 0.0;
+        if (!hardware_op(i->op, left, right, temps[i->dst - TEMPS]))
+            return false;
+    }
+    y = value(result);
+    return std::isfinite(y);
+}
@@ -353,6 +353,71 @@ public:
 };
 
 
+struct compiled_expression
+// ----------------------------------------------------------------------------
+//   An expression prepared for repeated numerical evaluation
+// ----------------------------------------------------------------------------
+//   Plotting, solving and integrating evaluate the same expression many
+//   times for different values of the independent variable. When the
+//   expression only contains numbers, variables containing numbers, the
+//   independent variable, arithmetic and elementary functions, it is
+//   compiled into a short sequence of operations calling the
+//   arithmetic code directly. Otherwise, or if anything goes wrong while
+//   evaluating, we use algebraic::evaluate_function.
+//   When all values are real, the same code can also be run with hardware
+//   doubles, which is used for fast plotting. That evaluation fails when
+//   the result is not finite or is likely to be inaccurate, letting the
+//   caller switch back to decimal evaluation.
+{
+    compiled_expression(program_r eq);
+    algebraic_p evaluate(algebraic_r x);
+    bool        evaluate(double x, double &y);
+    bool        fast_path() const       { return compiled && hardware; }
+
+private:
+    enum
+    {
+        MAX_DEPTH       = 8,    // Evaluation depth, kept on the RPL stack
+        MAX_VALUES      = 2,    // Values of numerical constants
+        MAX_OPERANDS    = 24,   // Numbers in the expression or in globals
+        MAX_CODE        = 32,   // Operations in the expression
+
+        // Operands are the independent variable, temporaries, values, numbers
+        X               = 0,
+        TEMPS           = 1,
+        VALUES          = TEMPS + MAX_DEPTH,
+        OPERANDS        = VALUES + MAX_VALUES
+    };
+
+    struct instruction
+    {
+        algebraic_fn  unary;
+        arithmetic_fn binary;
+        object::id    op;
+        byte          dst, x, y;
+    };
+
+    bool        compile();
+    algebraic_p operand(byte index, algebraic_r x);
+    static bool hardware_op(object::id op, double x, double y, double &r);
+
+private:
+    program_g   eq;
+    algebraic_g values[MAX_VALUES];
+    object_p    operands[MAX_OPERANDS]; // Global or offset in expression
+    uint32_t    relative;               // Operands that are offsets
+    double      dvalues[MAX_VALUES];    // Values as hardware doubles
+    double      doperands[MAX_OPERANDS]; // Operands as hardware doubles
+    instruction code[MAX_CODE];
+    uint        ncode;
+    uint        ntemps;
+    byte        result;
+    uint        globals;
+    bool        compiled;
+    bool        hardware;               // All values convert to double
+};
+
+
 
 
 // ============================================================================
@@ -37,21 +37,6 @@
 RECORDER(fraction, 16, "Fractions");
 
 
-static ularge gcd(ularge a, ularge b)
-// ----------------------------------------------------------------------------
-//   Compute the greatest common denominator between a and b
-// ----------------------------------------------------------------------------
-{
-    while (b)
-    {
-        ularge na = b;
-        b = a % b;
-        a = na;
-    }
-    return a;
-}
-
-
 SIZE_BODY(fraction)
 // ----------------------------------------------------------------------------
 //   Return the size of an LEB128-encoded fraction
@@ -146,7 +131,7 @@ fraction_g fraction::make(integer_g n, integer_g d)
 {
     ularge nv = n->value<ularge>();
     ularge dv = d->value<ularge>();
-    ularge cd = gcd(nv, dv);
+    ularge cd = bignum::gcd(nv, dv);
     bool neg = (n->type() == ID_neg_integer) != (d->type() == ID_neg_integer);
     if (cd > 1)
     {
@@ -280,27 +265,20 @@ bignum_g big_fraction::denominator() const
 }
 
 
-static bignum_g gcd(bignum_g a, bignum_g b)
-// ----------------------------------------------------------------------------
-//   Compute the greatest common denominator between a and b
-// ----------------------------------------------------------------------------
-{
-    while (b && !b->is_zero())
-    {
-        bignum_g na = b;
-        b = a % b;
-        a = na;
-    }
-    return a;
-}
-
-
 fraction_g big_fraction::make(bignum_g n, bignum_g d)
 // ----------------------------------------------------------------------------
 //   Create a reduced fraction from n and d
 // ----------------------------------------------------------------------------
 {
-    bignum_g cd = gcd(n, d);
+    if (!n || !d)
+        return nullptr;
+
+    // If both fit in 64 bits, reduce with native integers
+    if (integer_g ni = (integer *) n->as_integer())
+        if (integer_g di = (integer *) d->as_integer())
+            return fraction::make(ni, di);
+
+    bignum_g cd = bignum::gcd(n, d);
     if (!cd)
         return nullptr;
     if (!cd->is(1))
@@ -311,7 +289,7 @@ fraction_g big_fraction::make(bignum_g n, bignum_g d)
     if (!n || !d)
         return nullptr;
 
-    // Check if numerator and denominator are small enough to use LEB128
+    // Check if reduced numerator and denominator can use LEB128
     if (integer_g ni = (integer *) n->as_integer())
         if (integer_g di = (integer *) d->as_integer())
             return fraction::make(ni, di);
@@ -43,6 +43,8 @@
 #include "tag.h"
 #include "unit.h"
 
+#include <algorithm>
+
 
 bool function::should_be_symbolic(id type)
 // ----------------------------------------------------------------------------
@@ -1022,6 +1024,15 @@ NFUNCTION_BODY(xroot)
             }
         }
 
+        // Integer roots of real numbers use Newton's method
+        if (is_int && (y->is_decimal() || y->is_fractionable()))
+        {
+            algebraic_g yd = y;
+            algebraic_g xd = x;
+            if (to_decimal(yd) && to_decimal(xd))
+                return decimal::xroot(decimal_p(+yd), decimal_p(+xd));
+        }
+
         if (is_neg)
             x = -pow(-y, integer::make(1) / x);
         else
@@ -1042,6 +1053,102 @@ INSERT_BODY(cubed)
 }
 
 
+static algebraic_p product(ularge lo, ularge hi)
+// ----------------------------------------------------------------------------
+//   Product of all integers in [lo..hi], computed as a balanced tree
+// ----------------------------------------------------------------------------
+//   This keeps the operands of each multiplication of similar size, which
+//   is much faster for large ranges than multiplying one factor at a time.
+//   Leaves accumulate consecutive factors in a native integer while it fits.
+{
+    if (lo > hi)
+        return integer::make(1);
+
+    if (hi - lo >= 32)
+    {
+        ularge      mid   = lo + (hi - lo) / 2;
+        algebraic_g left  = product(lo, mid);
+        algebraic_g right = left ? product(mid + 1, hi) : nullptr;
+        return right ? left * right : nullptr;
+    }
+
+    algebraic_g result = nullptr;
+    ularge      acc    = 1;
+    for (ularge i = lo; ; i++)
+    {
+        if (acc > ~ularge(0) / i)
+        {
+            algebraic_g factor = integer::make(acc);
+            result = result ? result * factor : factor;
+            if (!result)
+                return nullptr;
+            acc = 1;
+        }
+        acc *= i;
+        if (i == hi)
+            break;
+    }
+    algebraic_g factor = integer::make(acc);
+    return result ? result * factor : factor;
+}
+
+
+static algebraic_p binomial_primes(ularge n, ularge k, ularge lo, ularge hi)
+// ----------------------------------------------------------------------------
+//   Product of p^e for primes p in [lo..hi] dividing n! / (k! (n-k)!)
+// ----------------------------------------------------------------------------
+//   The exponent of p is given by Legendre's formula, and p^e <= n.
+//   Each leaf sieves a small segment of integers using all divisors up to
+//   the square root of its upper bound.
+{
+    const uint SEGMENT = 512;
+    if (hi - lo >= SEGMENT)
+    {
+        ularge      mid   = lo + (hi - lo) / 2;
+        algebraic_g left  = binomial_primes(n, k, lo, mid);
+        algebraic_g right = left ? binomial_primes(n, k, mid + 1, hi) : nullptr;
+        return right ? left * right : nullptr;
+    }
+
+    bool composite[SEGMENT] = { false };
+    for (ularge d = 2; d * d <= hi; d++)
+    {
+        ularge first = std::max(d * d, (lo + d - 1) / d * d);
+        for (ularge m = first; m <= hi; m += d)
+            composite[m - lo] = true;
+    }
+
+    algebraic_g result = nullptr;
+    ularge      acc    = 1;
+    for (ularge p = std::max(lo, ularge(2)); p <= hi; p++)
+    {
+        if (composite[p - lo])
+            continue;
+        ularge factor = 1;
+        for (ularge q = p; q <= n; q *= p)
+        {
+            if ((n / q - k / q - (n - k) / q) > 0)
+                factor *= p;
+            if (q > n / p)
+                break;
+        }
+        if (factor == 1)
+            continue;
+        if (acc > ~ularge(0) / factor)
+        {
+            algebraic_g big = integer::make(acc);
+            result = result ? result * big : big;
+            if (!result)
+                return nullptr;
+            acc = 1;
+        }
+        acc *= factor;
+    }
+    algebraic_g big = integer::make(acc);
+    return result ? result * big : big;
+}
+
+
 FUNCTION_BODY(fact)
 // ----------------------------------------------------------------------------
 //   Perform factorial for integer values, fallback to gamma otherwise
@@ -1062,10 +1169,7 @@ FUNCTION_BODY(fact)
             rt.domain_error();
             return nullptr;
         }
-        algebraic_g result = integer::make(1);
-        for (uint i = 2; i <= max; i++)
-            result = result * integer::make(i);
-        return result;
+        return product(2, max);
     }
 
     if (x->is_decimal())
@@ -1106,11 +1210,20 @@ NFUNCTION_BODY(comb)
         {
             ularge ni = nval->value<ularge>();
             ularge mi = mval->value<ularge>();
-            n = integer::make(ni < mi ? 0 : 1);
-            for (ularge i = ni - mi + 1; i <= ni && n; i++)
-                n = n * algebraic_g(integer::make(i));
-            for (ularge i = 2; i <= mi && n; i++)
-                n = n / algebraic_g(integer::make(i));
+            if (ni < mi)
+                return integer::make(0);
+
+            // Use prime factorization unless the sieve would dominate,
+            // otherwise divide the falling product by k!
+            ularge ki = std::min(mi, ni - mi);
+            if (!ki)
+                return integer::make(1);
+            if (ni <= 16 * ki && ni <= (1U << 24))
+                return binomial_primes(ni, ki, 2, ni);
+            n = product(ni - ki + 1, ni);
+            m = product(2, ki);
+            if (n && m)
+                n = n / m;
             return n;
         }
     }
@@ -1136,10 +1249,9 @@ NFUNCTION_BODY(perm)
         {
             ularge ni = nval->value<ularge>();
             ularge mi = mval->value<ularge>();
-            n = integer::make(ni < mi ? 0 : 1);
-            for (ularge i = ni - mi + 1; i <= ni && n; i++)
-                n = n * algebraic_g(integer::make(i));
-            return n;
+            if (ni < mi)
+                return integer::make(0);
+            return product(ni - mi + 1, ni);
         }
     }
 
@@ -1151,6 +1263,161 @@ NFUNCTION_BODY(perm)
 }
 
 
+NFUNCTION_BODY(powmod)
+// ----------------------------------------------------------------------------
+//   Compute x^e mod m for integers, without computing x^e
+// ----------------------------------------------------------------------------
+{
+    algebraic_g x = args[2];
+    algebraic_g e = args[1];
+    algebraic_g m = args[0];
+    auto is_big = [](algebraic_r v)
+    {
+        return (v->is_integer() || v->is_bignum()) && !v->is_based();
+    };
+    if (is_big(x) && is_big(e) && is_big(m))
+    {
+        if (e->is_negative(false) || m->is_negative(false))
+        {
+            rt.value_error();
+            return nullptr;
+        }
+        bignum_promotion(x);
+        bignum_promotion(e);
+        bignum_promotion(m);
+        bignum_g xb = bignum_p(+x);
+        bignum_g eb = bignum_p(+e);
+        bignum_g mb = bignum_p(+m);
+        return bignum::powmod(xb, eb, mb);
+    }
+
+    if (x->is_real() && e->is_real() && m->is_real())
+        rt.value_error();
+    else
+        rt.type_error();
+    return nullptr;
+}
+
+
+static bignum_p integer_argument(bool *negative)
+// ----------------------------------------------------------------------------
+//   Return the integer on top of stack as a bignum for number theory
+// ----------------------------------------------------------------------------
+{
+    object_p top = rt.top();
+    if (!top)
+        return nullptr;
+    algebraic_g x = top->as_algebraic();
+    if (!x || !(x->is_integer() || x->is_bignum()) || x->is_based())
+    {
+        if (x && x->is_real())
+            rt.value_error();
+        else
+            rt.type_error();
+        return nullptr;
+    }
+    *negative = x->is_negative(false);
+    algebraic::bignum_promotion(x);
+    return bignum_p(+x);
+}
+
+
+static bool prime_factors(bignum_g n)
+// ----------------------------------------------------------------------------
+//   Append the prime factors of n to the scratchpad
+// ----------------------------------------------------------------------------
+//   Factors returned by bignum::factor may be composite when found by
+//   Pollard's rho, in which case they are factored recursively. Since
+//   they are less than the square root of n, the recursion is shallow.
+{
+    bignum_g one = rt.make<bignum>(object::ID_bignum, 1U);
+    while (n && one && bignum::compare(n, one) > 0)
+    {
+        bool prime = false;
+        if (!bignum::is_prime(n, &prime))
+            return false;
+        bignum_g f = prime ? n : bignum::factor(n);
+        if (!f)
+            return false;
+        if (prime)
+        {
+            object_g obj = f->as_integer();
+            if (!obj)
+                obj = +f;
+            return rt.append(obj->size(), byte_p(+obj));
+        }
+
+        bool fprime = false;
+        if (!bignum::is_prime(f, &fprime))
+            return false;
+        if (fprime)
+        {
+            object_g obj = f->as_integer();
+            if (!obj)
+                obj = +f;
+            if (!rt.append(obj->size(), byte_p(+obj)))
+                return false;
+        }
+        else if (!prime_factors(f))
+        {
+            return false;
+        }
+        n = n / f;
+    }
+    return n && one;
+}
+
+
+COMMAND_BODY(IsPrime)
+// ----------------------------------------------------------------------------
+//   Check if an integer is prime
+// ----------------------------------------------------------------------------
+{
+    bool     negative = false;
+    bignum_g x        = integer_argument(&negative);
+    bool     prime    = false;
+    if (!x || !bignum::is_prime(x, &prime))
+        return ERROR;
+    id type = prime && !negative ? ID_True : ID_False;
+    if (!rt.top(command::static_object(type)))
+        return ERROR;
+    return OK;
+}
+
+
+COMMAND_BODY(Factors)
+// ----------------------------------------------------------------------------
+//   Return the list of prime factors of an integer, in increasing order
+// ----------------------------------------------------------------------------
+//   A negative value has -1 as an additional factor.
+{
+    bool     negative = false;
+    bignum_g x        = integer_argument(&negative);
+    if (!x)
+        return ERROR;
+    if (x->is_zero())
+    {
+        rt.value_error();
+        return ERROR;
+    }
+
+    scribble scr;
+    if (negative)
+    {
+        integer_g minus_one = integer::make(-1);
+        if (!minus_one || !rt.append(minus_one->size(), byte_p(+minus_one)))
+            return ERROR;
+        x = -x;
+    }
+    if (!prime_factors(x))
+        return ERROR;
+    list_g factors = list::make(scr.scratch(), scr.growth());
+    if (!factors || !rt.top(+factors))
+        return ERROR;
+    return Sort::evaluate();
+}
+
+
 static algebraic_p sum_product(object::id op,
                                algebraic_g args[], uint arity)
 // ----------------------------------------------------------------------------
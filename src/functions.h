@@ -286,6 +286,7 @@ NFUNCTION(Truncate, 2, );
 NFUNCTION(xroot, 2, );
 NFUNCTION(comb, 2, );
 NFUNCTION(perm, 2, );
+NFUNCTION(powmod, 3, );
 NFUNCTION(Sum, 4,
           static bool can_be_symbolic(uint a)
           {
@@ -310,4 +311,7 @@ NFUNCTION(Percent, 2, );
 NFUNCTION(PercentChange, 2, );
 NFUNCTION(PercentTotal, 2, );
 
+COMMAND_DECLARE(IsPrime, 1);
+COMMAND_DECLARE(Factors, 1);
+
 #endif // FUNCTIONS_H
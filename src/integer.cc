@@ -325,12 +325,9 @@ PARSE_BODY(integer)
             default: break;
             }
 
-            // Integrate last digit that overflowed above
-            bignum_g bbase  = rt.make<bignum>(ID_bignum, base);
-            bignum_g bvalue = rt.make<bignum>(type, v);
-            bresult         = rt.make<bignum>(type, result);
-            bresult = bvalue + bbase * bresult; // Order matters for types
-
+            // Find remaining digits, starting with the one that overflowed
+            gcutf8 first   = s - 1;
+            size_t ndigits = 1;
             while (count--)
             {
                 v = value[*gs];
@@ -352,10 +349,14 @@ PARSE_BODY(integer)
                     return err;
                 }
                 record(integer, "Digit %c value %u in bignum", s[-1], v);
-                bvalue  = rt.make<bignum>(type, v);
-                bresult = bvalue + bbase * bresult;
+                ndigits++;
             }
 
+            // Convert all the digits at once
+            bresult = bignum::from_digits(type, base, result, first, ndigits);
+            if (!bresult)
+                return ERROR;
+
             s    = gs;
             endp = ge;
         }
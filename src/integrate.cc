@@ -130,9 +130,10 @@ algebraic_p integrate(program_g   eq,
     settings::SaveNumericalResults snr(true);
 
     // Initial integration step and first trapezoidal step
+    compiled_expression fn(eq);
     dx              = hx - lx;
-    sy              = algebraic::evaluate_function(eq, lx);
-    sy2             = algebraic::evaluate_function(eq, hx);
+    sy              = fn.evaluate(lx);
+    sy2             = fn.evaluate(hx);
     sy              = (sy + sy2) * dx / two;
     if (!dx || !sy)
         return nullptr;
@@ -161,7 +162,7 @@ algebraic_p integrate(program_g   eq,
                 goto error;
 
             // Evaluate equation
-            y  = algebraic::evaluate_function(eq, x);
+            y  = fn.evaluate(x);
 
             // Sum elements, and approximate when necessary
             sy = sy + y;
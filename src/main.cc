@@ -419,6 +419,10 @@ extern "C" void program_main()
             // Blink the cursor
             if (sys_timer_timeout(TIMER1))
                 redraw_periodics();
+
+            // Use idle time to collect garbage incrementally
+            if (Settings.IncrementalGC())
+                rt.gc_idle(Settings.IncrementalGCBudget());
         }
 #if SIMULATOR
         if (tests::running && test_command && key_empty())
@@ -423,11 +423,12 @@ MENU(NumbersMenu,
 
      "Σ",       ID_Sum,
      "∏",       ID_Product,
+     "PowMod",  ID_powmod,
 
-     "IsPrime", ID_Unimplemented,
+     "IsPrime", ID_IsPrime,
      "NextPr",  ID_Unimplemented,
      "PrevPr",  ID_Unimplemented,
-     "Factors", ID_Unimplemented,
+     "Factors", ID_Factors,
      "Random",  ID_Unimplemented,
      "Seed",    ID_Unimplemented);
 
@@ -201,16 +201,37 @@ object_p object::parse(utf8 source, size_t &size, int precedence)
     size_t slen = 0;
     result r    = SKIP;
 
+    // Most IDs use the default parser, which always skips, or are commands,
+    // which are all parsed by ID_Drop. Only probe the other handlers,
+    // keeping the order where ID_symbol comes last
+    static uint16_t candidates[NUM_IDS];
+    static uint     count = 0;
+    if (!count)
+    {
+        for (uint i = 0; i < NUM_IDS; i++)
+        {
+            // Parse ID_symbol last, we need to check commands first
+            uint     candidate = (i + ID_symbol + 1) % NUM_IDS;
+            parse_fn parse     = handler[candidate].parse;
+            if (parse == (parse_fn) object::do_parse)
+                continue;
+            if (parse == (parse_fn) command::do_parse && candidate != ID_Drop)
+                continue;
+            candidates[count++] = candidate;
+        }
+        record(parse, "Parsing with %u out of %u handlers", count, NUM_IDS);
+    }
+
     // Try parsing with the various handlers
     do
     {
         r = SKIP;
-        for (uint i = 0; r == SKIP && i < NUM_IDS; i++)
+        for (uint i = 0; r == SKIP && i < count; i++)
         {
-            // Parse ID_symbol last, we need to check commands first
-            uint candidate = (i + ID_symbol + 1) % NUM_IDS;
+            uint candidate = candidates[i];
             p.candidate = id(candidate);
-            record(parse_attempts, "Trying [%s] against %+s", src, name(id(i)));
+            record(parse_attempts, "Trying [%s] against %+s",
+                   src, name(id(candidate)));
             r = handler[candidate].parse(p);
             if (r == COMMENTED)
             {
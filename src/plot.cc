@@ -128,6 +128,23 @@ uint draw_data(array::iterator &it, array::iterator &end,
 
 
 
+static coord pixel_adjust(double pos, double min, double max, uint scale)
+// ----------------------------------------------------------------------------
+//   Hardware floating-point equivalent of PlotParametersAccess::pixel_adjust
+// ----------------------------------------------------------------------------
+{
+    double range = max - min;
+    if (range == 0.0)
+        range = 1.0;
+    pos = (pos - min) / range * scale;
+    if (pos <= double(INT32_MIN))
+        return INT32_MIN;
+    if (pos >= double(INT32_MAX))
+        return INT32_MAX;
+    return coord(pos);
+}
+
+
 object::result draw_plot(object::id                  kind,
                          const PlotParametersAccess &ppar,
                          object_g                    to_plot = nullptr)
@@ -238,6 +255,7 @@ object::result draw_plot(object::id                  kind,
     save<symbol_g *> iref(expression::independent,
                           (symbol_g *) &ppar.independent);
     settings::PrepareForProgramEvaluation willRunPrograms;
+    compiled_expression fn(eq);
     if (ui.draw_graphics())
         if (Settings.DrawPlotAxes())
             draw_axes(ppar);
@@ -246,14 +264,61 @@ object::result draw_plot(object::id                  kind,
     size    lw           = Settings.LineWidth();
     pattern fg           = Settings.Foreground();
 
+    // Sample functions and polar curves with hardware floating-point when
+    // possible, falling back to decimal for points where that fails
+    bool   fast   = false;
+    ularge index  = 0;
+    ularge points = 0;
+    double dmin = 0, dstep = 0, dxmin = 0, dxmax = 0, dymin = 0, dymax = 0;
+    double dpoints = 0, dx = 0;
+    if ((kind == object::ID_Function || kind == object::ID_Polar) &&
+        Settings.FastPlot() && fn.fast_path())
+    {
+        algebraic_g count = (max - min) / step;
+        fast = (algebraic::to_double(+count, dpoints)    &&
+                algebraic::to_double(+min, dmin)         &&
+                algebraic::to_double(+step, dstep)       &&
+                algebraic::to_double(+ppar.xmin, dxmin)  &&
+                algebraic::to_double(+ppar.xmax, dxmax)  &&
+                algebraic::to_double(+ppar.ymin, dymin)  &&
+                algebraic::to_double(+ppar.ymax, dymax)  &&
+                dpoints >= 0.0 && dpoints < 0x1p53);
+        if (fast)
+            points = ularge(dpoints + 0x1p-20);
+        dx = dmin;
+        rt.clear_error();
+    }
+
     while (!program::interrupted())
     {
         coord rx     = 0;
         coord ry     = 0;
         uint  dcount = 1;
-        if (dname == object::ID_Equation)
+        bool  hw     = false;
+        if (fast)
         {
-            y = algebraic::evaluate_function(eq, x);
+            double dy;
+            hw = fn.evaluate(dx, dy);
+            if (hw)
+            {
+                double px = dx;
+                if (kind == object::ID_Polar)
+                {
+                    px = dy * std::cos(dx);
+                    dy = dy * std::sin(dx);
+                }
+                rx = pixel_adjust(px, dxmin, dxmax, Screen.area().width());
+                ry = pixel_adjust(dy, dymax, dymin, Screen.area().height());
+            }
+            else
+            {
+                x = min + step * integer::make(index);
+                y = fn.evaluate(x);
+            }
+        }
+        else if (dname == object::ID_Equation)
+        {
+            y = fn.evaluate(x);
         }
         else
         {
@@ -262,7 +327,7 @@ object::result draw_plot(object::id                  kind,
                 break;
         }
 
-        if (y)
+        if (!hw && y)
         {
             switch(kind)
             {
@@ -298,7 +363,7 @@ object::result draw_plot(object::id                  kind,
             }
         }
 
-        if (y)
+        if (hw || y)
         {
             if (kind != object::ID_Bar)
             {
@@ -335,7 +400,13 @@ object::result draw_plot(object::id                  kind,
         }
 
 
-        if (kind != object::ID_Scatter)
+        if (fast)
+        {
+            if (++index > points)
+                break;
+            dx = dmin + double(index) * dstep;
+        }
+        else if (kind != object::ID_Scatter)
         {
             x = x + step;
             if (kind != object::ID_Bar)
@@ -32,6 +32,7 @@
 #include "arithmetic.h"
 #include "compare.h"
 #include "constants.h"
+#include "dmcp.h"
 #include "integer.h"
 #include "object.h"
 #include "program.h"
@@ -52,6 +53,7 @@ RECORDER(errors,        16, "Runtime errors)");
 RECORDER(gc,           256, "Garbage collection events");
 RECORDER(gc_errors,     16, "Garbage collection errors");
 RECORDER(gc_details,   256, "Details about garbage collection (noisy)");
+RECORDER(gc_timing,     64, "Garbage collection timing");
 
 
 // ============================================================================
@@ -71,6 +73,8 @@ runtime::runtime(byte *mem, size_t size)
       ErrorCommand(nullptr),
       LowMem(),
       Globals(),
+      Slack(0),
+      GlobalsGeneration(0),
       Temporaries(),
       Editing(),
       Scratch(),
@@ -82,7 +86,11 @@ runtime::runtime(byte *mem, size_t size)
       CallStack(),
       Returns(),
       HighMem(),
-      SaveArgs(false)
+      SaveArgs(false),
+      GCStats(),
+      GCNext(0),
+      GCDone(0),
+      GCGeneration(0)
 {
     if (mem)
         memory(mem, size);
@@ -111,9 +119,13 @@ void runtime::memory(byte *memory, size_t size)
     directory_p home = new((void *) Globals) directory();   // Home directory
     *Directories = (object_p) home;             // Current search path
     Globals = home->skip();                     // Globals after home
+    Slack = 0;                                  // No room reserved for globals
+    GlobalsGeneration++;                        // Invalidate global caches
     Temporaries = Globals;                      // Area for temporaries
     Editing = 0;                                // No editor
     Scratch = 0;                                // No scratchpad
+    GCNext = 0;                                 // No incremental GC cycle
+    GCDone = 0;
 
     record(runtime, "Memory %p-%p size %u (%uK)",
            LowMem, HighMem, size, size>>10);
@@ -159,7 +171,10 @@ size_t runtime::available(size_t size)
 {
     if (available() < size)
     {
-        gc();
+        if (Settings.IncrementalGC())
+            gc_step(Settings.IncrementalGCBudget(), size - available());
+        if (available() < size)
+            gc();
         size_t avail = available();
         if (avail < size)
             out_of_memory_error();
@@ -301,6 +316,31 @@ runtime::gcptr::~gcptr()
 }
 
 
+// Root slots are tagged in the low bit when they are GC-safe pointers, which
+// also keep alive the object that ends exactly where they point
+static const uintptr_t GC_INCLUSIVE = 1;
+
+
+static inline byte_p gc_root_value(uintptr_t root)
+// ----------------------------------------------------------------------------
+//   Return the value held by a tagged root slot
+// ----------------------------------------------------------------------------
+{
+    return *(byte_p *) (root & ~GC_INCLUSIVE);
+}
+
+
+static int gc_root_compare(const void *left, const void *right)
+// ----------------------------------------------------------------------------
+//   Sort root slots by the address they point to
+// ----------------------------------------------------------------------------
+{
+    byte_p l = gc_root_value(*(const uintptr_t *) left);
+    byte_p r = gc_root_value(*(const uintptr_t *) right);
+    return l < r ? -1 : l > r ? 1 : 0;
+}
+
+
 size_t runtime::gc()
 // ----------------------------------------------------------------------------
 //   Recycle unused temporaries
@@ -309,16 +349,16 @@ size_t runtime::gc()
 //   Objects in the global area are copied there, so they need no recycling
 //   This algorithm is linear in number of objects and moves only live data
 {
+    uint     start    = sys_current_ms();
     size_t   recycled = 0;
+    size_t   slack    = release_slack();
     object_p first    = (object_p) Globals;
     object_p last     = Temporaries;
-    object_p free     = first;
-    object_p next;
 
     ui.draw_busy(L'●', Settings.GCIconForeground());
 
-    record(gc, "Garbage collection, available %u, range %p-%p",
-           available(), first, last);
+    record(gc, "Garbage collection, available %u, range %p-%p, slack %u",
+           available(), first, last, slack);
 #ifdef SIMULATOR
     if (!integrity_test(first, last, Stack, CallStack))
     {
@@ -334,6 +374,331 @@ size_t runtime::gc()
                          first, last, Stack, CallStack);
 #endif // SIMULATOR
 
+    // Compact all temporaries, moving the command line and scratch buffer
+    recycled = gc_window(first, last);
+
+    // A full collection completes any pending incremental cycle
+    GCNext = 0;
+    GCDone = Temporaries - Globals;
+
+#ifdef SIMULATOR
+    if (!integrity_test(Globals, Temporaries, Stack, CallStack))
+    {
+        record(gc_errors, "Integrity test failed post-collection");
+        RECORDER_TRACE(gc) = 2;
+        dump_object_list("Post-collection failure",
+                         first, last, Stack, CallStack);
+        recorder_dump();
+    }
+    if (RECORDER_TRACE(gc) > 1)
+        dump_object_list("Post-collection",
+                         (object_p) Globals, Temporaries,
+                         Stack, CallStack);
+#endif // SIMULATOR
+
+    uint duration = sys_current_ms() - start;
+    GCStats.cycles++;
+    GCStats.purged += recycled;
+    GCStats.duration += duration;
+    GCStats.last = duration;
+    record(gc_timing, "Collected %u bytes in %u ms", recycled, duration);
+    record(gc, "Garbage collection done, purged %u, available %u",
+           recycled, available());
+
+    ui.draw_busy();
+    return recycled;
+}
+
+
+size_t runtime::gc_step(uint budget, size_t wanted)
+// ----------------------------------------------------------------------------
+//   Run a time-bounded slice of incremental garbage collection
+// ----------------------------------------------------------------------------
+//   An incremental cycle walks the temporaries from bottom to top in small
+//   windows of objects. Each window is compacted like a full collection, and
+//   the gap is closed by moving everything above it down with `move`, so that
+//   memory is fully consistent between two slices. The position where the
+//   next slice resumes is kept as an offset from Globals, which stays valid
+//   when `move_globals` shifts the temporaries.
+//   The slice stops when `wanted` bytes were recycled, when the cycle is
+//   complete, or when `budget` milliseconds have elapsed.
+{
+    const uint window   = 256;
+    size_t     recycled = 0;
+    uint       start    = sys_current_ms();
+    uint       duration = 0;
+
+    if (GCNext > size_t(Temporaries - Globals))
+        GCNext = 0;
+
+    record(gc, "Incremental collection from %u, budget %u ms, want %u",
+           GCNext, budget, wanted);
+    do
+    {
+        object_p first = Globals + GCNext;
+        object_p last  = Temporaries;
+        if (first >= last)
+        {
+            GCNext = 0;
+            GCDone = Temporaries - Globals;
+            GCStats.cycles++;
+            break;
+        }
+
+        // Select the next window of objects
+        object_p end = first;
+        for (uint n = 0; n < window && end < last; n++)
+            end = end->skip();
+
+        size_t purged = gc_window(first, end);
+        recycled += purged;
+        GCNext = end - purged - Globals;
+        duration = sys_current_ms() - start;
+    } while (recycled < wanted && duration < budget);
+
+    GCStats.purged += recycled;
+    GCStats.duration += duration;
+    GCStats.last = duration;
+    record(gc_timing, "Incremental step collected %u bytes in %u ms, next %u",
+           recycled, duration, GCNext);
+    return recycled;
+}
+
+
+size_t runtime::gc_window(object_p first, object_p end)
+// ----------------------------------------------------------------------------
+//   Compact the objects in a window and close the gap above it
+// ----------------------------------------------------------------------------
+//   Root slots are sorted in the free memory above the scratchpad. When there
+//   are more roots than fit there, which is common when collecting because
+//   memory is exhausted, the window is split at the highest object boundary
+//   whose roots still fit. Every sub-window we compact closes its gap, so the
+//   free memory available to sort roots grows as we progress.
+{
+    size_t recycled = 0;
+    while (first < end)
+    {
+        uintptr_t free = uintptr_t(scratchpad());
+        free = (free + sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1);
+        uintptr_t *sorted   = (uintptr_t *) free;
+        uintptr_t *limit    = (uintptr_t *) Stack;
+        size_t     capacity = sorted < limit ? limit - sorted : 0;
+
+        object_p last = end;
+        if (gc_roots(nullptr, first, last) > capacity)
+            last = gc_cutoff(first, end, capacity);
+
+        // If roots for the first object do not fit, scan for it alone
+        size_t purged = last > first
+            ? gc_sorted(sorted, first, last)
+            : gc_scan(first, last = first->skip());
+
+        // Move everything above the window down, adjusting pointers
+        if (purged)
+        {
+            GCGeneration++;
+            object_p top = (object_p) scratchpad();
+            move(last - purged, last, top - last, 1);
+            Temporaries -= purged;
+            end -= purged;
+            recycled += purged;
+        }
+        first = last - purged;
+    }
+    return recycled;
+}
+
+
+object_p runtime::gc_cutoff(object_p first, object_p end, size_t capacity)
+// ----------------------------------------------------------------------------
+//   Find the highest object boundary below which roots fit in `capacity`
+// ----------------------------------------------------------------------------
+//   This bisects on addresses, counting roots at each step, which costs a
+//   logarithmic number of passes over the roots instead of one per object.
+{
+    if (gc_roots(nullptr, first, first) > capacity)
+        return first;
+
+    byte_p lo = byte_p(first);
+    byte_p hi = byte_p(end);
+    while (hi - lo > 1)
+    {
+        byte_p mid = lo + (hi - lo) / 2;
+        if (gc_roots(nullptr, first, object_p(mid)) <= capacity)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    object_p last = first;
+    object_p next;
+    for (object_p obj = first; obj < end; obj = next)
+    {
+        next = obj->skip();
+        if (byte_p(next) > lo)
+            break;
+        last = next;
+    }
+    return last;
+}
+
+
+size_t runtime::gc_nursery(object_p first)
+// ----------------------------------------------------------------------------
+//   Collect short-lived temporaries allocated above `first`
+// ----------------------------------------------------------------------------
+//   This is only done once the nursery uses more than the available memory,
+//   so that nurseries rarely collect when there is plenty of free memory,
+//   but reclaim short-lived objects before a full collection is required.
+{
+    if (first < Globals || first >= Temporaries)
+        return 0;
+    size_t young = Temporaries - first;
+    if (young < available())
+        return 0;
+
+    uint   start    = sys_current_ms();
+    size_t recycled = gc_window(first, Temporaries);
+    uint   duration = sys_current_ms() - start;
+
+    // An incremental cycle within the nursery resumes at its first object
+    if (Globals + GCNext > first)
+        GCNext = first - Globals;
+    GCStats.purged += recycled;
+    GCStats.duration += duration;
+    GCStats.last = duration;
+    record(gc_timing, "Nursery collected %u of %u bytes in %u ms",
+           recycled, young, duration);
+    return recycled;
+}
+
+
+size_t runtime::gc_idle(uint budget)
+// ----------------------------------------------------------------------------
+//   Run an incremental collection slice if memory changed since last cycle
+// ----------------------------------------------------------------------------
+{
+    if (!GCNext && GCDone == size_t(Temporaries - Globals))
+        return 0;
+    return gc_step(budget);
+}
+
+
+size_t runtime::gc_roots(uintptr_t *roots, object_p first, object_p last)
+// ----------------------------------------------------------------------------
+//   Collect the root slots pointing in the given range, return their count
+// ----------------------------------------------------------------------------
+//   If `roots` is null, only count the slots pointing in the range.
+//   Otherwise, store the address of each slot that points between `first`
+//   and `last` (inclusive), tagging GC-safe pointers with GC_INCLUSIVE.
+{
+    utf8 *label = (utf8 *) &ui.menu_label[0][0];
+
+    size_t count = 0;
+    byte_p lo    = byte_p(first);
+    byte_p hi    = byte_p(last);
+
+#define GC_ROOT(slot, tag)                                              \
+    do                                                                  \
+    {                                                                   \
+        byte_p value = byte_p(*(slot));                                 \
+        if (value >= lo && value <= hi)                                 \
+        {                                                               \
+            if (roots)                                                  \
+                roots[count] = uintptr_t(slot) | (tag);                 \
+            count++;                                                    \
+        }                                                               \
+    } while (0)
+
+    for (object_p *s = Stack; s < HighMem; s++)
+        GC_ROOT(s, 0);
+    for (gcptr *p = GCSafe; p; p = p->next)
+        GC_ROOT(&p->safe, GC_INCLUSIVE);
+    GC_ROOT(&Error, 0);
+    GC_ROOT(&ErrorSave, 0);
+    GC_ROOT(&ErrorSource, 0);
+    GC_ROOT(&ErrorCommand, 0);
+    GC_ROOT(&ui.command, 0);
+    for (uint l = 0; l < ui.NUM_MENUS; l++)
+        GC_ROOT(&label[l], 0);
+
+#undef GC_ROOT
+
+    return count;
+}
+
+
+size_t runtime::gc_sorted(uintptr_t *roots, object_p first, object_p last)
+// ----------------------------------------------------------------------------
+//   Compact objects by merging the object walk with sorted root slots
+// ----------------------------------------------------------------------------
+//   The roots are collected and sorted once, after which a single pass over
+//   the objects finds the live ones and adjusts the slots that point to them.
+//   The slots are stored in free memory, which compaction does not touch.
+{
+    size_t     count    = gc_roots(roots, first, last);
+    uintptr_t *root     = roots;
+    uintptr_t *end      = roots + count;
+    size_t     recycled = 0;
+    object_p   free     = first;
+    object_p   next;
+
+    qsort(roots, count, sizeof(*roots), gc_root_compare);
+    record(gc_details, "Sorted %u roots", count);
+
+    for (object_p obj = first; obj < last; obj = next)
+    {
+        next = obj->skip();
+        record(gc_details, "Scanning object %p (ends at %p)", obj, next);
+
+        // Roots below `obj` were consumed by earlier objects
+        uintptr_t *inside = root;
+        while (root < end && gc_root_value(*root) < byte_p(next))
+            root++;
+        bool found = root > inside;
+
+        // GC-safe pointers also keep the object that ends at them
+        for (uintptr_t *r = root; !found && r < end; r++)
+        {
+            if (gc_root_value(*r) != byte_p(next))
+                break;
+            found = *r & GC_INCLUSIVE;
+        }
+
+        size_t size = next - obj;
+        if (found)
+        {
+            record(gc_details, "Moving %p-%p to %p", obj, next, free);
+            if (int delta = free - obj)
+            {
+                memmove((byte *) free, (byte *) obj, size);
+                for (uintptr_t *r = inside; r < root; r++)
+                    *(byte_p *) (*r & ~GC_INCLUSIVE) += delta;
+            }
+            free += size;
+        }
+        else
+        {
+            recycled += size;
+            record(gc_details, "Recycling %p size %u total %u",
+                   obj, size, recycled);
+        }
+    }
+
+    return recycled;
+}
+
+
+size_t runtime::gc_scan(object_p first, object_p last)
+// ----------------------------------------------------------------------------
+//   Compact objects by scanning all roots for each object
+// ----------------------------------------------------------------------------
+//   This is only used when there is not enough free memory to sort roots
+{
+    size_t   recycled = 0;
+    object_p free     = first;
+    object_p next;
+
     object_p *firstobjptr = Stack;
     object_p *lastobjptr = HighMem;
 
@@ -392,36 +757,6 @@ size_t runtime::gc()
         }
     }
 
-    // Move the command line and scratch buffer
-    if (Editing + Scratch)
-    {
-        object_p edit = Temporaries;
-        move(edit - recycled, edit, Editing + Scratch, 1, true);
-    }
-
-    // Adjust Temporaries
-    Temporaries -= recycled;
-
-
-#ifdef SIMULATOR
-    if (!integrity_test(Globals, Temporaries, Stack, CallStack))
-    {
-        record(gc_errors, "Integrity test failed post-collection");
-        RECORDER_TRACE(gc) = 2;
-        dump_object_list("Post-collection failure",
-                         first, last, Stack, CallStack);
-        recorder_dump();
-    }
-    if (RECORDER_TRACE(gc) > 1)
-        dump_object_list("Post-collection",
-                         (object_p) Globals, Temporaries,
-                         Stack, CallStack);
-#endif // SIMULATOR
-
-    record(gc, "Garbage collection done, purged %u, available %u",
-           recycled, available());
-
-    ui.draw_busy();
     return recycled;
 }
 
@@ -508,21 +843,70 @@ void runtime::move_globals(object_p to, object_p from)
 // ----------------------------------------------------------------------------
 //    Move data in the globals area
 // ----------------------------------------------------------------------------
-//    In that case, we need to move everything up to the scratchpad
+//    When the change fits in the slack at the end of globals, only the globals
+//    above `from` need to move. Otherwise, we move temporaries, the editor and
+//    scratchpad up, reserving some additional slack so that a variable that
+//    grows in a loop does not move the whole memory at each iteration.
+//    The slack is given back to temporaries by the next garbage collection.
 {
+    int      delta = to - from;
+    object_p used  = Globals - Slack;
+    object_p last  = (object_p) scratchpad();
+    GlobalsGeneration++;
+    if (from >= LowMem && from <= used)
+    {
+        if (delta > int(Slack))
+        {
+            size_t needed = delta - Slack;
+            size_t avail  = available();
+            size_t extra  = avail > needed ? (avail - needed) / 16 : 0;
+            if (extra > 4096)
+                extra = 4096;
+            size_t grow = needed + extra;
+            move(Globals + grow, Globals, last - Globals, 1);
+            Globals += grow;
+            Temporaries += grow;
+            Slack += grow;
+        }
+
+        // A gcp to the end of globals may point to the first temporary
+        move(to, from, used - from, Slack ? 1 : 0);
+        Slack -= delta;
+        return;
+    }
+
     // We overscan by 1 to deal with gcp that point to end of objects
-    object_p last = (object_p) scratchpad() + allocated();
     object_p first = to < from ? to : from;
     size_t moving = last - first;
     move(to, from, moving, 1);
 
     // Adjust Globals and Temporaries (for Temporaries, must be <=, not <)
-    int delta = to - from;
     if (Globals >= first && Globals < last)             // Storing global var
         Globals += delta;
+    else if (Globals + GCNext > first)                  // Incremental GC
+        GCNext = 0;
     Temporaries += delta;
 }
 
+
+size_t runtime::release_slack()
+// ----------------------------------------------------------------------------
+//   Move temporaries down to recover the slack at end of globals
+// ----------------------------------------------------------------------------
+{
+    size_t slack = Slack;
+    if (slack)
+    {
+        GCGeneration++;
+        object_p last = (object_p) scratchpad();
+        move(Globals - slack, Globals, last - Globals, 1);
+        Globals -= slack;
+        Temporaries -= slack;
+        Slack = 0;
+    }
+    return slack;
+}
+
 #ifdef DM42
 #  pragma GCC pop_options
 #endif // DM42
@@ -1244,6 +1628,7 @@ bool runtime::enter(directory_p dir)
 
     // Update directory
     *Directories = dir;
+    GlobalsGeneration++;
 
     return true;
 }
@@ -1272,6 +1657,7 @@ bool runtime::updir(size_t count)
     size_t moving = Directories - Stack;
     for (size_t i = 0; i < moving; i++)
         *(--newp) = *(--oldp);
+    GlobalsGeneration++;
 
     return true;
 }
@@ -65,6 +65,7 @@
 //      Temporaries     Temporaries, allocated up
 //        [Previously allocated temporary objects, can be garbage collected]
 //      Globals         End of global named RPL objects
+//        [Slack, free space for globals to grow without moving temporaries]
 //        [Top-level directory of global objects]
 //      LowMem          Bottom of memory
 //
@@ -294,6 +295,58 @@ struct runtime
     //   Garbage collector (purge unused objects from memory to make space)
     // ------------------------------------------------------------------------
 
+    size_t gc_step(uint budget, size_t wanted = ~size_t(0));
+    // ------------------------------------------------------------------------
+    //   Incremental garbage collection for at most `budget` milliseconds
+    // ------------------------------------------------------------------------
+
+    size_t gc_idle(uint budget);
+    // ------------------------------------------------------------------------
+    //   Incremental garbage collection if memory changed since last cycle
+    // ------------------------------------------------------------------------
+
+    size_t gc_nursery(object_p first);
+    // ------------------------------------------------------------------------
+    //   Collect young objects above `first` if they fill free memory
+    // ------------------------------------------------------------------------
+
+    size_t gc_window(object_p first, object_p end);
+    object_p gc_cutoff(object_p first, object_p end, size_t capacity);
+    size_t gc_roots(uintptr_t *roots, object_p first, object_p last);
+    size_t gc_sorted(uintptr_t *roots, object_p first, object_p last);
+    size_t gc_scan(object_p first, object_p last);
+    // ------------------------------------------------------------------------
+    //   Mark and compact phases, with sorted roots or scanning all roots
+    // ------------------------------------------------------------------------
+
+
+    struct gc_statistics
+    // ------------------------------------------------------------------------
+    //   Statistics about garbage collection
+    // ------------------------------------------------------------------------
+    {
+        uint    cycles;         // Number of garbage collection cycles
+        size_t  purged;         // Total number of bytes purged
+        uint    duration;       // Total time spent collecting (ms)
+        uint    last;           // Duration of last collection (ms)
+    };
+
+    const gc_statistics &gc_stats() const
+    // ------------------------------------------------------------------------
+    //   Return the garbage collection statistics
+    // ------------------------------------------------------------------------
+    {
+        return GCStats;
+    }
+
+    uint gc_generation() const
+    // ------------------------------------------------------------------------
+    //   Return a counter that changes whenever garbage collection moves objects
+    // ------------------------------------------------------------------------
+    {
+        return GCGeneration;
+    }
+
 
     void move(object_p to, object_p from,
               size_t sz, size_t overscan = 0, bool scratch=false);
@@ -304,7 +357,12 @@ struct runtime
 
     void move_globals(object_p to, object_p from);
     // ------------------------------------------------------------------------
-    //    Move data in the globals area (move everything up to end of scratch)
+    //    Move data in the globals area, using slack at the end if possible
+    // ------------------------------------------------------------------------
+
+    size_t release_slack();
+    // ------------------------------------------------------------------------
+    //    Return the slack at the end of globals to temporaries
     // ------------------------------------------------------------------------
 
 
@@ -812,6 +870,30 @@ struct runtime
     bool enter(directory_p dir);
     bool updir(size_t count = 1);
 
+    bool is_global(object_p obj) const
+    // ------------------------------------------------------------------------
+    //   Check if an object lives in the globals area
+    // ------------------------------------------------------------------------
+    {
+        return obj >= LowMem && obj < Globals;
+    }
+
+    uint globals_generation() const
+    // ------------------------------------------------------------------------
+    //   Return a counter that changes with globals or the current directory
+    // ------------------------------------------------------------------------
+    {
+        return GlobalsGeneration;
+    }
+
+    void globals_changed()
+    // ------------------------------------------------------------------------
+    //   Invalidate any information cached about the globals
+    // ------------------------------------------------------------------------
+    {
+        GlobalsGeneration++;
+    }
+
 
 
     // ========================================================================
@@ -952,6 +1034,8 @@ protected:
     object_p  ErrorCommand; // Source of the error if known
     object_p  LowMem;       // Bottom of available memory
     object_p  Globals;      // End of global objects
+    size_t    Slack;        // Free space reserved at the end of globals
+    uint      GlobalsGeneration; // Changes with globals or current directory
     object_p  Temporaries;  // Temporaries (must be valid objects)
     size_t    Editing;      // Text editor (utf8 encoded)
     size_t    Scratch;      // Scratch pad (may be invalid objects)
@@ -964,6 +1048,10 @@ protected:
     object_p *Returns;      // Start of return stack, end of locals
     object_p *HighMem;      // End of available memory
     bool      SaveArgs;     // Save arguents (LastArgs)
+    gc_statistics GCStats;  // Garbage collection statistics
+    size_t    GCNext;       // Offset where next incremental GC step resumes
+    size_t    GCDone;       // Size of temporaries after last GC cycle
+    uint      GCGeneration; // Changes when objects are moved by GC
 
     // Pointers that are GC-adjusted
     static gcptr *GCSafe;
@@ -1100,6 +1188,27 @@ private:
 };
 
 
+struct nursery
+// ----------------------------------------------------------------------------
+//   Region for short-lived temporaries, e.g. in numerical series
+// ----------------------------------------------------------------------------
+//   Objects allocated after the nursery is created can be reclaimed by
+//   `collect` without walking older temporaries. Survivors, i.e. objects
+//   still referenced from the stack or a gcp, are compacted at the bottom
+//   of the nursery. The start of the nursery is itself a GC-safe pointer,
+//   so that it follows the objects if a full garbage collection occurs.
+{
+    nursery(): start(rt.editor()) {}    // Editor begins at end of temporaries
+    size_t collect()
+    {
+        return rt.gc_nursery((object_p) +start);
+    }
+
+private:
+    gcbytes start;
+};
+
+
 struct stack_depth_restore
 // ----------------------------------------------------------------------------
 //   Restore the stack depth on exit
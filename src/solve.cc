@@ -140,6 +140,7 @@ algebraic_p solve(program_g eq, symbol_g name, object_g guess)
     int              prec = Settings.SolverPrecision();
     algebraic_g      eps = decimal::make(1, -prec);
 
+    compiled_expression fn(eq);
     bool is_constant = true;
     bool is_valid = false;
     uint max = Settings.SolverIterations();
@@ -148,7 +149,7 @@ algebraic_p solve(program_g eq, symbol_g name, object_g guess)
         bool           jitter = false;
 
         // Evaluate equation
-        y = algebraic::evaluate_function(eq, x);
+        y = fn.evaluate(x);
         record(solve, "[%u] x=%t y=%t", i, +x, +y);
         if (!y)
         {
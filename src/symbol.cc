@@ -46,13 +46,53 @@
 #include <stdio.h>
 
 
+// Inline cache remembering where global symbols in programs were found
+struct symbol_cache
+// ----------------------------------------------------------------------------
+//   Inline cache entry for a symbol evaluated from a program
+// ----------------------------------------------------------------------------
+//   A call site is identified by the address of the symbol object, which is
+//   stable until garbage collection moves it. The value is a global, which
+//   is stable until a variable is stored or purged or the path changes.
+{
+    symbol_p site;
+    object_p value;
+    uint     globals;
+    uint     gc;
+    bool     ignore_case;
+};
+static const uint   SYMBOL_CACHE_SIZE = 64;
+static symbol_cache symbol_caches[SYMBOL_CACHE_SIZE];
+
+
 EVAL_BODY(symbol)
 // ----------------------------------------------------------------------------
 //   Evaluate a symbol by looking it up
 // ----------------------------------------------------------------------------
 {
+    uintptr_t     addr    = uintptr_t(o);
+    uint          index   = (addr ^ (addr >> 6)) % SYMBOL_CACHE_SIZE;
+    symbol_cache &cache   = symbol_caches[index];
+    bool          special = expression::independent || expression::dependent;
+    if (!special                                        &&
+        cache.site == o                                 &&
+        cache.globals == rt.globals_generation()        &&
+        cache.gc == rt.gc_generation()                  &&
+        cache.ignore_case == Settings.IgnoreSymbolCase())
+        return program::run_program(cache.value);
+
     if (object_p found = directory::recall_all(o, false))
+    {
+        if (!special && rt.is_global(found))
+        {
+            cache.site = o;
+            cache.value = found;
+            cache.globals = rt.globals_generation();
+            cache.gc = rt.gc_generation();
+            cache.ignore_case = Settings.IgnoreSymbolCase();
+        }
         return program::run_program(found);
+    }
     if (unit::mode)
         if (unit_p u = unit::lookup(o))
             if (rt.push(u))
@@ -237,6 +237,7 @@ bool directory::store(object_g name, object_g value)
 
         // Copy new value into storage location
         memmove((byte *) evalue, (byte *) value, vs);
+        rt.globals_changed();
 
         // Compute change in size for directories
         delta = vs - es;
@@ -327,6 +328,126 @@ void directory::adjust_sizes(directory_r thisdir, int delta)
 }
 
 
+// ============================================================================
+//
+//   Directory index
+//
+// ============================================================================
+//
+//   Looking up a name in a large directory is a linear search, which makes
+//   symbol-heavy programs slow when directories hold hundreds of variables.
+//   To speed this up, we keep a hash index of symbol names for the few most
+//   recently searched directories in the globals area.
+//   The index lives outside of the directory object, so that the format is
+//   unchanged. It is rebuilt lazily when the globals generation changes,
+//   which happens whenever a variable is stored or purged.
+//   The index holds offsets of names relative to the directory body, with
+//   linear probing in insertion order, so that the first match is the same
+//   as with a linear search, even if names only differ by case.
+
+static const uint DIRECTORY_INDEX_MIN   = 8; // Smaller dirs are scanned
+static const uint DIRECTORY_INDEX_COUNT = 4; // Number of directories indexed
+
+struct directory_index
+// ----------------------------------------------------------------------------
+//   Hash index for a directory
+// ----------------------------------------------------------------------------
+{
+    directory_p dir;            // Indexed directory
+    uint        generation;     // Globals generation when index was built
+    uint        mask;           // Number of slots - 1
+    uint32_t   *slots;          // Name offset + 1, 0 for empty slots
+};
+static directory_index directory_indexes[DIRECTORY_INDEX_COUNT];
+static uint            directory_index_next = 0;
+
+
+static uint directory_hash(utf8 txt, size_t len)
+// ----------------------------------------------------------------------------
+//   Hash a symbol name, ignoring case so that it works for both settings
+// ----------------------------------------------------------------------------
+{
+    uint hash = 2166136261U;
+    for (size_t i = 0; i < len; i++)
+    {
+        byte c = txt[i];
+        if (c >= 'A' && c <= 'Z')
+            c += 'a' - 'A';
+        hash = (hash ^ c) * 16777619U;
+    }
+    return hash;
+}
+
+
+static directory_index *directory_index_find(directory_p dir)
+// ----------------------------------------------------------------------------
+//   Return a valid index for the directory, or null to use a linear search
+// ----------------------------------------------------------------------------
+{
+    if (!rt.is_global(dir))
+        return nullptr;
+
+    uint generation = rt.globals_generation();
+    for (uint i = 0; i < DIRECTORY_INDEX_COUNT; i++)
+    {
+        directory_index &ix = directory_indexes[i];
+        if (ix.dir == dir && ix.generation == generation)
+            return ix.slots ? &ix : nullptr;
+    }
+
+    // Count symbols in the directory
+    byte_p p     = dir->payload();
+    size_t size  = leb128<size_t>(p);
+    byte_p body  = p;
+    byte_p end   = p + size;
+    uint   count = 0;
+    for (byte_p q = body; q < end; q = byte_p(object_p(q)->skip()->skip()))
+        count++;
+
+    // Build the index even when it is not worth it, to remember that
+    directory_index &ix = directory_indexes[directory_index_next];
+    directory_index_next = (directory_index_next + 1) % DIRECTORY_INDEX_COUNT;
+    ix.dir = dir;
+    ix.generation = generation;
+    if (count < DIRECTORY_INDEX_MIN)
+    {
+        free(ix.slots);
+        ix.slots = nullptr;
+        return nullptr;
+    }
+
+    uint slots = 16;
+    while (slots < 2 * count)
+        slots *= 2;
+    uint32_t *table = (uint32_t *) realloc(ix.slots, slots * sizeof(*table));
+    if (!table)
+    {
+        free(ix.slots);
+        ix.slots = nullptr;
+        return nullptr;
+    }
+    memset(table, 0, slots * sizeof(*table));
+    ix.slots = table;
+    ix.mask = slots - 1;
+
+    for (byte_p q = body; q < end; q = byte_p(object_p(q)->skip()->skip()))
+    {
+        if (symbol_p sym = object_p(q)->as<symbol>())
+        {
+            size_t len;
+            utf8   txt  = sym->value(&len);
+            uint   slot = directory_hash(txt, len) & ix.mask;
+            while (table[slot])
+                slot = (slot + 1) & ix.mask;
+            table[slot] = q - body + 1;
+        }
+    }
+    record(directory, "Indexed %u names in %p using %u slots",
+           count, dir, slots);
+    return &ix;
+}
+
+
 object_p directory::lookup(object_p ref) const
 // ----------------------------------------------------------------------------
 //   Find if the name exists in the directory, if so return pointer to it
@@ -337,6 +458,28 @@ object_p directory::lookup(object_p ref) const
     size_t   rsize = ref->size();
     symbol_p rsym  = ref->as<symbol>();
 
+    // Symbols in large directories are found using the hash index
+    if (rsym)
+    {
+        if (directory_index *ix = directory_index_find(this))
+        {
+            size_t len;
+            utf8   txt  = rsym->value(&len);
+            uint   slot = directory_hash(txt, len) & ix->mask;
+            while (uint32_t offset = ix->slots[slot])
+            {
+                object_p name = object_p(p + offset - 1);
+                if (name == ref)
+                    return name;
+                if (symbol_p nsym = name->as<symbol>())
+                    if (rsym->is_same_as(nsym))
+                        return name;
+                slot = (slot + 1) & ix->mask;
+            }
+            return nullptr;
+        }
+    }
+
     while (size)
     {
         object_p name = (object_p) p;
@@ -915,6 +1058,24 @@ COMMAND_BODY(GarbageCollect)
 }
 
 
+COMMAND_BODY(GarbageCollectorStatistics)
+// ----------------------------------------------------------------------------
+//   Return a list with purged bytes, cycles, total and last duration in ms
+// ----------------------------------------------------------------------------
+{
+    const runtime::gc_statistics &stats = rt.gc_stats();
+    integer_g purged   = integer::make(stats.purged);
+    integer_g cycles   = integer::make(stats.cycles);
+    integer_g duration = integer::make(stats.duration);
+    integer_g last     = integer::make(stats.last);
+    if (purged && cycles && duration && last)
+        if (list_p result = list::make(purged, cycles, duration, last))
+            if (rt.push(result))
+                return OK;
+    return ERROR;
+}
+
+
 COMMAND_BODY(FreeMemory)
 // ----------------------------------------------------------------------------
 //   Return amount of free memory (available without garbage collection)